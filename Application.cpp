@@ -3,6 +3,8 @@
 #include "classes/TicTacToe.h"
 #include "classes/Checkers.h"
 #include "classes/Othello.h"
+#include "classes/TextureCache.h"
+#include "classes/Profiler.h"
 // NEW:
 #include "classes/Connect4.h"
 
@@ -13,6 +15,7 @@ namespace ClassGame {
         Game *game = nullptr;
         bool gameOver = false;
         int gameWinner = -1;
+        bool showProfiler = false;
 
         //
         // game starting point
@@ -21,6 +24,8 @@ namespace ClassGame {
         void GameStartUp() 
         {
             game = nullptr;
+            // decode the piece and board images in the background so no game has to wait on them
+            TextureCache::instance().startPreload();
         }
 
         //
@@ -29,12 +34,30 @@ namespace ClassGame {
         //
         void RenderGame() 
         {
+#ifdef ENABLE_PROFILER
+                Profiler::instance().beginFrame();
+#endif
+                PROFILE_SCOPE("RenderGame");
                 ImGui::DockSpaceOverViewport();
 
                 //ImGui::ShowDemoWindow();
 
+                // a couple of uploads per frame keeps startup frames smooth while the preloader finishes
+                TextureCache &textures = TextureCache::instance();
+                textures.uploadPending(2);
+
                 ImGui::Begin("Settings");
 
+#ifdef ENABLE_PROFILER
+                ImGui::Checkbox("Show Profiler", &showProfiler);
+#endif
+
+                if (!textures.preloadFinished()) {
+                    char overlay[32];
+                    snprintf(overlay, sizeof(overlay), "%d/%d textures", textures.uploadedCount(), textures.totalCount());
+                    ImGui::ProgressBar(textures.progress(), ImVec2(-1, 0), overlay);
+                }
+
                 if (gameOver) {
                     ImGui::Text("Game Over!");
                     if (gameWinner > 0) {
@@ -62,6 +85,10 @@ namespace ClassGame {
                         game = new TicTacToe();
                         game->setUpBoard();
                     }
+                    if (ImGui::Button("Start Gomoku")) {
+                        game = new TicTacToe(15, 15, 5);
+                        game->setUpBoard();
+                    }
                     if (ImGui::Button("Start Checkers")) {
                         game = new Checkers();
                         game->setUpBoard();
@@ -84,6 +111,63 @@ namespace ClassGame {
                     } else {
                         ImGui::Text("Current Player Number: %d", game->getCurrentPlayer()->playerNumber());
                         ImGui::Text("Current Board State: %s", game->stateString().c_str());
+                        const BitPool &pool = game->_bitPool;
+                        ImGui::Text("Pieces: %d live, %d created, %d heap allocations", pool.liveCount(), pool.totalAcquired(), pool.heapAllocations());
+                        bool batched = game->batchedDrawing();
+                        if (ImGui::Checkbox("Batched board drawing", &batched)) {
+                            game->setBatchedDrawing(batched);
+                        }
+                        ImGui::Text("Board draw: %.3f ms", game->paintTimeMs());
+                        SearchStats stats;
+                        if (game->gameHasAI() && game->aiSearchStats(stats)) {
+                            ImGui::Separator();
+                            stats.draw();
+                            ImGui::Separator();
+                        }
+                    }
+                    const GameHistory &history = game->history();
+                    ImGui::Text("History: %d moves, %.1f KB", history.moveCount(), history.memoryUsed() / 1024.0f);
+                    ImGui::Text("Position Hash: %016llx", (unsigned long long)game->snapshot().hash());
+
+                    // scrub through the game on the live board, stepping one move at a time
+                    int cursor = game->historyCursor();
+                    bool historyChanged = false;
+                    if (ImGui::SliderInt("Move", &cursor, 0, history.moveCount())) {
+                        game->seekHistory(cursor);
+                        historyChanged = true;
+                    }
+                    ImGui::BeginDisabled(!game->canUndo());
+                    if (ImGui::Button("Undo")) {
+                        game->undoMove();
+                        historyChanged = true;
+                    }
+                    ImGui::EndDisabled();
+                    ImGui::SameLine();
+                    ImGui::BeginDisabled(!game->canRedo());
+                    if (ImGui::Button("Redo")) {
+                        game->redoMove();
+                        historyChanged = true;
+                    }
+                    ImGui::EndDisabled();
+                    if (game->isReviewingHistory()) {
+                        ImGui::SameLine();
+                        if (ImGui::Button("Play From Here")) {
+                            game->resumeFromHistory();
+                            historyChanged = true;
+                        }
+                    }
+                    // positions are saved as a binary snapshot, only the same game can load one back
+                    if (ImGui::Button("Save Position")) {
+                        game->savePosition("position.bin");
+                    }
+                    ImGui::SameLine();
+                    if (ImGui::Button("Load Position") && game->loadPosition("position.bin")) {
+                        historyChanged = true;
+                    }
+                    if (historyChanged) {
+                        gameOver = false;
+                        gameWinner = -1;
+                        EndOfTurn();
                     }
                 }
                 ImGui::End();
@@ -105,14 +189,37 @@ namespace ClassGame {
                         c4->drawFrame();
                     } else {
                         // Original behavior for TicTacToe / Checkers / Othello
-                        if (game->gameHasAI() && (game->getCurrentPlayer()->isAIPlayer() || game->_gameOptions.AIvsAI))
+                        if (game->isWaitingOnAI())
                         {
+                            PROFILE_SCOPE("Game::updateAI");
                             game->updateAI();
                         }
                         game->drawFrame();
                     }
                 }
                 ImGui::End();
+
+#ifdef ENABLE_PROFILER
+                if (showProfiler) {
+                    Profiler::instance().drawWindow(&showProfiler);
+                }
+#endif
+        }
+
+        //
+        // the main loop asks this before blocking on input. a static board is only redrawn when
+        // something happens, so frames keep coming while textures upload, pieces move or an AI
+        // still has to play
+        //
+        bool WantsContinuousFrames()
+        {
+            if (!TextureCache::instance().preloadFinished()) {
+                return true;
+            }
+            if (!game) {
+                return false;
+            }
+            return game->isAnimating() || (!gameOver && game->isWaitingOnAI());
         }
 
         //
@@ -4,4 +4,6 @@ namespace ClassGame {
     void GameStartUp();
     void RenderGame();
     void EndOfTurn();
+    // false once nothing on screen changes without input, the main loop then waits for events
+    bool WantsContinuousFrames();
 }
@@ -0,0 +1,444 @@
+#pragma once
+
+#include "SearchStats.h"
+#include "TranspositionTable.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+//
+// negamax alpha-beta shared by the game AIs, header only so every game's position inlines.
+// a game describes its position through SearchPosition and gets iterative deepening, a
+// transposition table, killer and history move ordering, time control and SearchStats.
+// principal variation search gives every move after the first a null window that only asks
+// whether it beats the best so far, and searches it properly when it does. aspiration starts
+// each iteration with a narrow window around the score of the iteration before and widens the
+// side it falls out of. both leave the score unchanged, they only change how many nodes it
+// takes to prove it, and each can be turned off to measure what it gains.
+// scores are from the side to move's point of view, forced results are P::kWinScore less the
+// ply they happen at, so a quicker win always scores higher.
+// the table can be shared between engines searching the same game on different threads.
+//
+
+//
+// what a game has to provide.
+//   generateMoves   legal moves into a buffer of kMaxMoves in the order the game prefers, the
+//                   table remembers the best move by its index, so the order must be repeatable
+//   play / undo     change the position in place, undo always gets the move just played
+//   terminal        a result that needs no moves generated (a line already made), as a score
+//   noMovesScore    the score when generateMoves comes back empty
+//   moveKey         [0, kMoveKeys) for the history table, the same move gets the same key
+//
+template <typename P>
+concept SearchPosition = requires(P &position, const P &constPosition, typename P::Move move,
+                                  typename P::Move *moves, int ply, int &score) {
+    { P::kMaxMoves } -> std::convertible_to<int>;
+    { P::kWinScore } -> std::convertible_to<int>;
+    { P::kMoveKeys } -> std::convertible_to<int>;
+    { constPosition.generateMoves(moves) } -> std::same_as<int>;
+    position.play(move);
+    position.undo(move);
+    { constPosition.evaluate() } -> std::same_as<int>;
+    { constPosition.hash() } -> std::same_as<uint64_t>;
+    { constPosition.terminal(ply, score) } -> std::same_as<bool>;
+    { constPosition.noMovesScore(ply) } -> std::same_as<int>;
+    { constPosition.moveKey(move) } -> std::same_as<int>;
+};
+
+// optional: keep searching past the horizon until the moves are quiet (checkers captures)
+template <typename P>
+concept HasQuietTest = requires(const P &position, const typename P::Move *moves, int count) {
+    { position.isQuiet(moves, count) } -> std::same_as<bool>;
+};
+
+// optional: an exact answer from somewhere else (endgame tables), as a score
+template <typename P>
+concept HasProbe = requires(const P &position, int ply, int &score) {
+    { position.probe(ply, score) } -> std::same_as<bool>;
+};
+
+// deepest ply the engine searches to, positions that keep a stack per ply can size it from this
+const int kAlphaBetaMaxPly = 64;
+
+template <SearchPosition Position>
+class AlphaBeta
+{
+public:
+    using Move = typename Position::Move;
+
+    static const int kMaxPly = kAlphaBetaMaxPly;
+    static const int kWinScore = Position::kWinScore;
+    // timeLimitMs for a search bounded by depth alone
+    static const int kNoTimeLimit = 24 * 60 * 60 * 1000;
+    static_assert(Position::kMaxMoves < TranspositionTable::kNoMove, "the table keeps the best move as a byte index");
+
+    struct Options
+    {
+        bool    principalVariation = true;
+        bool    aspiration = true;
+        bool    table = true;
+        int     aspirationWindow = 50;      // half width of the first window, in the game's units
+    };
+
+    struct Result
+    {
+        Move        move{};
+        int         index = -1;         // into the root moves
+        int         score = 0;
+        int         depth = 0;
+        uint64_t    nodes = 0;
+        bool        found = false;
+    };
+
+    explicit AlphaBeta(size_t tableSize = 1 << 18)
+        : _ownTable(std::make_unique<TranspositionTable>(tableSize)), _table(*_ownTable)
+    {
+    }
+    // search with a table other engines use too, it has to outlive this one
+    explicit AlphaBeta(TranspositionTable &table)
+        : _table(table)
+    {
+    }
+
+    // search the root moves for up to maxDepth plies or timeLimitMs milliseconds, whichever
+    // is first. the position is played on in place and is back where it started afterwards
+    Result      search(Position &position, const Move *rootMoves, int rootCount, int maxDepth, int timeLimitMs);
+
+    // ask a running search to return as soon as possible, the request sticks until clearStop
+    void        stop() { _stop.store(true); }
+    void        clearStop() { _stop.store(false); }
+    // counters of the running or last search, safe to call from any thread
+    SearchStats stats() const { return _published.latest(); }
+
+    static bool isWin(int score) { return score > kWinScore - 1000 || score < -kWinScore + 1000; }
+
+    const Options &options() const { return _options; }
+    void        setOptions(const Options &options) { _options = options; }
+
+    //
+    // called with every root move's score (its index, the depth and the score) as each one is
+    // searched, for showing all of them rather than only picking the best. with a listener set
+    // every root move gets the full window so each score is exact, and the search only stops
+    // early once all of them are forced results
+    //
+    using RootListener = std::function<void(int index, int depth, int score)>;
+    void        setRootListener(RootListener listener) { _rootListener = std::move(listener); }
+
+private:
+    int         searchRoot(Position &position, const Move *rootMoves, int rootCount, int depth, int alpha, int beta, int &bestSlot);
+    int         searchChild(Position &position, const Move &move, int depth, int alpha, int beta, int ply, bool scout);
+    int         negamax(Position &position, int depth, int alpha, int beta, int ply);
+    int         orderMoves(const Position &position, const Move *moves, int count, int ttIndex, int ply, int *order) const;
+    void        noteCutoff(const Position &position, const Move &move, int depth, int ply, bool first);
+    bool        timeUp();
+    void        publishStats(bool running);
+
+    // forced results are stored relative to the node so they read right from any ply
+    static int  scoreToTable(int score, int ply) { return !isWin(score) ? score : (score > 0 ? score + ply : score - ply); }
+    static int  scoreFromTable(int score, int ply) { return !isWin(score) ? score : (score > 0 ? score - ply : score + ply); }
+
+    Options                 _options;
+    std::unique_ptr<TranspositionTable> _ownTable;
+    TranspositionTable     &_table;
+    std::vector<int>        _rootOrder;     // root moves in the order they get searched
+    std::vector<int>        _rootScores;    // by root move, with a listener
+    RootListener            _rootListener;
+    int                     _killers[kMaxPly][2];
+    std::vector<int>        _history = std::vector<int>(Position::kMoveKeys);
+
+    std::atomic<bool>       _stop{false};
+    bool                    _aborted = false;
+    std::chrono::steady_clock::time_point _start;
+    std::chrono::steady_clock::time_point _deadline;
+    SearchStats             _stats;
+    SearchStatsChannel      _published;
+};
+
+template <SearchPosition Position>
+bool AlphaBeta<Position>::timeUp()
+{
+    if (_aborted) {
+        return true;
+    }
+    if ((_stats.nodes & 1023) == 0 && (_stop.load(std::memory_order_relaxed) || std::chrono::steady_clock::now() >= _deadline)) {
+        _aborted = true;
+    }
+    if ((_stats.nodes & 16383) == 0) {
+        publishStats(true);
+    }
+    return _aborted;
+}
+
+template <SearchPosition Position>
+void AlphaBeta<Position>::publishStats(bool running)
+{
+    _stats.timeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _start).count();
+    _stats.running = running;
+    _published.publish(_stats);
+}
+
+//
+// table move first, then this ply's killers, then the rest by how often they have cut off
+// before. ties keep the game's own order, so with an empty history nothing changes
+//
+template <SearchPosition Position>
+int AlphaBeta<Position>::orderMoves(const Position &position, const Move *moves, int count, int ttIndex, int ply, int *order) const
+{
+    auto priority = [&](int index) {
+        if (index == ttIndex) return 3;
+        if (ply < kMaxPly) {
+            int key = position.moveKey(moves[index]);
+            if (key == _killers[ply][0]) return 2;
+            if (key == _killers[ply][1]) return 1;
+        }
+        return 0;
+    };
+    for (int i = 0; i < count; i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order, order + count, [&](int a, int b) {
+        int pa = priority(a), pb = priority(b);
+        if (pa != pb) return pa > pb;
+        return _history[position.moveKey(moves[a])] > _history[position.moveKey(moves[b])];
+    });
+    return count;
+}
+
+template <SearchPosition Position>
+void AlphaBeta<Position>::noteCutoff(const Position &position, const Move &move, int depth, int ply, bool first)
+{
+    _stats.betaCutoffs++;
+    _stats.firstMoveCutoffs += first;
+    int key = position.moveKey(move);
+    _history[key] += depth * depth;
+    if (ply < kMaxPly && _killers[ply][0] != key) {
+        _killers[ply][1] = _killers[ply][0];
+        _killers[ply][0] = key;
+    }
+}
+
+template <SearchPosition Position>
+int AlphaBeta<Position>::negamax(Position &position, int depth, int alpha, int beta, int ply)
+{
+    _stats.nodes++;
+    _stats.selDepth = std::max(_stats.selDepth, ply);
+    if (timeUp()) {
+        return 0;
+    }
+
+    int score;
+    if (position.terminal(ply, score)) {
+        return score;
+    }
+    if constexpr (HasProbe<Position>) {
+        if (position.probe(ply, score)) {
+            return score;
+        }
+    }
+    if constexpr (!HasQuietTest<Position>) {
+        if (depth <= 0 || ply >= kMaxPly) {
+            return position.evaluate();
+        }
+    }
+
+    Move moves[Position::kMaxMoves];
+    int count = position.generateMoves(moves);
+    if (count == 0) {
+        return position.noMovesScore(ply);
+    }
+    if constexpr (HasQuietTest<Position>) {
+        if ((depth <= 0 && position.isQuiet(moves, count)) || ply >= kMaxPly) {
+            return position.evaluate();
+        }
+    }
+
+    // the side to move can't win sooner than its own move or lose sooner than the reply to it,
+    // so once a quicker result is already in hand there is nothing left to find here
+    alpha = std::max(alpha, -(kWinScore - (ply + 2)));
+    beta = std::min(beta, kWinScore - (ply + 1));
+    if (alpha >= beta) {
+        return alpha;
+    }
+
+    uint64_t key = _options.table ? position.hash() : 0;
+    TranspositionTable::Entry entry;
+    int ttIndex = -1;
+    _stats.ttProbes += _options.table;
+    if (_options.table && _table.probe(key, entry)) {
+        _stats.ttHits++;
+        ttIndex = entry.move < count ? entry.move : -1;
+        if (entry.depth >= depth) {
+            int stored = scoreFromTable(entry.score, ply);
+            if (entry.bound == TranspositionTable::kExact) return stored;
+            if (entry.bound == TranspositionTable::kLower && stored >= beta) return stored;
+            if (entry.bound == TranspositionTable::kUpper && stored <= alpha) return stored;
+        }
+    }
+
+    int order[Position::kMaxMoves];
+    orderMoves(position, moves, count, ttIndex, ply, order);
+
+    int originalAlpha = alpha;
+    int best = -kWinScore - 1;
+    int bestIndex = order[0];
+    for (int i = 0; i < count; i++) {
+        const Move &move = moves[order[i]];
+        score = searchChild(position, move, depth, alpha, beta, ply, _options.principalVariation && i > 0);
+        if (_aborted) {
+            return 0;
+        }
+        if (score > best) {
+            best = score;
+            bestIndex = order[i];
+        }
+        alpha = std::max(alpha, score);
+        if (alpha >= beta) {
+            noteCutoff(position, move, std::max(depth, 1), ply, i == 0);
+            break;
+        }
+    }
+
+    if (_options.table) {
+        _stats.ttStores++;
+        TranspositionTable::Bound bound = best <= originalAlpha ? TranspositionTable::kUpper
+                                        : (best >= beta ? TranspositionTable::kLower : TranspositionTable::kExact);
+        _stats.ttCollisions += _table.store(key, scoreToTable(best, ply), std::max(depth, 0), bound, (uint8_t)bestIndex);
+    }
+    return best;
+}
+
+//
+// play move and search it. a scout only asks whether the move beats alpha with a null window,
+// and only when it does is it searched again with the real one to find by how much
+//
+template <SearchPosition Position>
+int AlphaBeta<Position>::searchChild(Position &position, const Move &move, int depth, int alpha, int beta, int ply, bool scout)
+{
+    position.play(move);
+    int score;
+    if (scout) {
+        score = -negamax(position, depth - 1, -alpha - 1, -alpha, ply + 1);
+        if (score > alpha && score < beta && !_aborted) {
+            score = -negamax(position, depth - 1, -beta, -alpha, ply + 1);
+        }
+    } else {
+        score = -negamax(position, depth - 1, -beta, -alpha, ply + 1);
+    }
+    position.undo(move);
+    return score;
+}
+
+template <SearchPosition Position>
+int AlphaBeta<Position>::searchRoot(Position &position, const Move *rootMoves, int rootCount, int depth, int alpha, int beta, int &bestSlot)
+{
+    bool exact = (bool)_rootListener;
+    int best = -kWinScore - 1;
+    bestSlot = 0;
+    for (int slot = 0; slot < rootCount; slot++) {
+        int index = _rootOrder[slot];
+        int score = searchChild(position, rootMoves[index], depth, alpha, beta, 0, _options.principalVariation && slot > 0 && !exact);
+        if (_aborted) {
+            break;
+        }
+        if (score > best) {
+            best = score;
+            bestSlot = slot;
+        }
+        if (exact) {
+            _rootScores[index] = score;
+            _rootListener(index, depth, score);
+            continue;
+        }
+        alpha = std::max(alpha, score);
+        if (alpha >= beta) {
+            break;
+        }
+    }
+    return best;
+}
+
+template <SearchPosition Position>
+typename AlphaBeta<Position>::Result AlphaBeta<Position>::search(Position &position, const Move *rootMoves, int rootCount, int maxDepth, int timeLimitMs)
+{
+    Result result;
+    if (rootCount <= 0) {
+        return result;
+    }
+
+    _aborted = false;
+    _stats = SearchStats();
+    _stats.usesTable = _options.table;
+    _start = std::chrono::steady_clock::now();
+    _deadline = _start + std::chrono::milliseconds(timeLimitMs);
+    std::fill(&_killers[0][0], &_killers[0][0] + kMaxPly * 2, -1);
+    std::fill(_history.begin(), _history.end(), 0);
+    _table.newSearch();
+
+    result.found = true;
+    result.index = 0;
+    result.move = rootMoves[0];
+    if (rootCount == 1 && !_rootListener) {
+        // forced, don't waste the player's time
+        publishStats(false);
+        return result;
+    }
+
+    // the previous iteration's best root move goes first
+    _rootOrder.resize(rootCount);
+    for (int i = 0; i < rootCount; i++) {
+        _rootOrder[i] = i;
+    }
+    _rootScores.assign(rootCount, 0);
+
+    const int fullAlpha = -kWinScore - 1;
+    const int fullBeta = kWinScore + 1;
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        int best;
+        int bestSlot;
+        if (_options.aspiration && depth > 1 && !_rootListener) {
+            // outside the window the score is only a bound, widen that side and search again
+            int64_t delta = _options.aspirationWindow;
+            int alpha = (int)std::max<int64_t>((int64_t)result.score - delta, fullAlpha);
+            int beta = (int)std::min<int64_t>((int64_t)result.score + delta, fullBeta);
+            for (;;) {
+                best = searchRoot(position, rootMoves, rootCount, depth, alpha, beta, bestSlot);
+                if (_aborted) {
+                    break;
+                }
+                if (best <= alpha) {
+                    alpha = (int)std::max<int64_t>(alpha - delta, fullAlpha);
+                } else if (best >= beta) {
+                    beta = (int)std::min<int64_t>(beta + delta, fullBeta);
+                } else {
+                    break;
+                }
+                delta = std::min<int64_t>(delta * 4, fullBeta);
+            }
+        } else {
+            best = searchRoot(position, rootMoves, rootCount, depth, fullAlpha, fullBeta, bestSlot);
+        }
+        if (_aborted) {
+            break;
+        }
+        std::rotate(_rootOrder.begin(), _rootOrder.begin() + bestSlot, _rootOrder.begin() + bestSlot + 1);
+        result.index = _rootOrder[0];
+        result.move = rootMoves[_rootOrder[0]];
+        result.score = best;
+        result.depth = depth;
+        _stats.depth = depth;
+        publishStats(true);
+        // a forced win or loss won't change with more depth
+        bool decided = _rootListener ? std::all_of(_rootScores.begin(), _rootScores.end(), isWin) : isWin(best);
+        if (decided) {
+            break;
+        }
+    }
+    result.nodes = _stats.nodes;
+    publishStats(false);
+    return result;
+}
@@ -1,12 +1,29 @@
 
 #include "Bit.h"
 #include "BitHolder.h"
+#include "BitPool.h"
 #include <cmath>
 
 Bit::~Bit()
 {
 }
 
+void Bit::destroy(Bit *bit)
+{
+	if (!bit)
+	{
+		return;
+	}
+	if (bit->_pool)
+	{
+		bit->_pool->release(bit);
+	}
+	else
+	{
+		delete bit;
+	}
+}
+
 BitHolder *Bit::getHolder()
 {
 	// Look for my nearest ancestor that's a BitHolder:
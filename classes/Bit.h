@@ -4,6 +4,7 @@
 
 class Player;
 class BitHolder;
+class BitPool;
 
 //
 // these aren't used yet but will be used for dragging pieces
@@ -29,10 +30,15 @@ public:
 		_gameTag = 0;
 		_entityType = EntityBit;
 		_moving = false;
+		_pool = nullptr;
 	};
 
 	~Bit();
 
+	// free a bit, handing it back to the pool it came from if it has one
+	static void destroy(Bit *bit);
+	void setPool(BitPool *pool) { _pool = pool; };
+
 	// helper functions
 	bool getPickedUp();
 	void setPickedUp(bool yes);
@@ -63,4 +69,5 @@ private:
 	ImVec2 _destinationPosition;
 	ImVec2 _destinationStep;
 	bool _moving;
+	BitPool *_pool;
 };
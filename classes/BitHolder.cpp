@@ -28,7 +28,7 @@ void BitHolder::setBit(Bit *abit)
 	{
 		if (_bit)
 		{
-			delete _bit;
+			Bit::destroy(_bit);
 			_bit = nullptr;
 		}
 		_bit = abit;
@@ -43,7 +43,7 @@ void BitHolder::destroyBit()
 {
 	if (_bit)
 	{
-		delete _bit;
+		Bit::destroy(_bit);
 		_bit = nullptr;
 	}
 }
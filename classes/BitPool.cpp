@@ -0,0 +1,45 @@
+#include "BitPool.h"
+#include "Bit.h"
+#include <new>
+
+namespace
+{
+    // each slot holds a Bit, or the free list link while it is unused
+    constexpr size_t kSlotAlign = alignof(Bit) > alignof(void *) ? alignof(Bit) : alignof(void *);
+    constexpr size_t kSlotSize = ((sizeof(Bit) > sizeof(void *) ? sizeof(Bit) : sizeof(void *)) + kSlotAlign - 1) & ~(kSlotAlign - 1);
+    static_assert(kSlotAlign <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "slab storage is not aligned enough for Bit");
+}
+
+Bit *BitPool::acquire()
+{
+    if (!_freeList) {
+        addSlab();
+    }
+    FreeSlot *slot = _freeList;
+    _freeList = slot->next;
+    _liveCount++;
+    _totalAcquired++;
+    Bit *bit = new (slot) Bit();
+    bit->setPool(this);
+    return bit;
+}
+
+void BitPool::release(Bit *bit)
+{
+    bit->~Bit();
+    FreeSlot *slot = new (bit) FreeSlot{_freeList};
+    _freeList = slot;
+    _liveCount--;
+}
+
+//
+// new slots are pushed back to front so a fresh slab hands them out in address order
+//
+void BitPool::addSlab()
+{
+    _slabs.emplace_back(new unsigned char[kSlotSize * kSlabSize]);
+    unsigned char *storage = _slabs.back().get();
+    for (int i = kSlabSize - 1; i >= 0; i--) {
+        _freeList = new (storage + i * kSlotSize) FreeSlot{_freeList};
+    }
+}
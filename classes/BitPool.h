@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+class Bit;
+
+//
+// per game pool for the pieces on the board
+// bits are built in place inside fixed size slabs, and a freed bit's slot goes on an
+// intrusive free list for the next piece, so placing, capturing, flipping and resetting
+// only touch the heap when every slab is full.
+//
+
+class BitPool
+{
+public:
+    static const int kSlabSize = 64;
+
+    BitPool() = default;
+    ~BitPool() = default;
+    BitPool(const BitPool &) = delete;
+    BitPool &operator=(const BitPool &) = delete;
+
+    // a freshly constructed bit that remembers this pool
+    Bit *       acquire();
+    // destroy the bit and keep its slot for the next acquire
+    void        release(Bit *bit);
+
+    // debug counters, heapAllocations is how many times the pool itself went to the heap
+    int         liveCount() const { return _liveCount; }
+    int         capacity() const { return (int)_slabs.size() * kSlabSize; }
+    int         totalAcquired() const { return _totalAcquired; }
+    int         heapAllocations() const { return (int)_slabs.size(); }
+
+private:
+    // a free slot reuses the bit's storage for the link to the next free one
+    struct FreeSlot
+    {
+        FreeSlot *  next;
+    };
+
+    void        addSlab();
+
+    std::vector<std::unique_ptr<unsigned char[]>> _slabs;
+    FreeSlot *  _freeList = nullptr;
+    int         _liveCount = 0;
+    int         _totalAcquired = 0;
+};
@@ -0,0 +1,57 @@
+#include "BoardSnapshot.h"
+
+namespace
+{
+    // splitmix64 finalizer, each word is folded in so the order of planes matters
+    uint64_t mix(uint64_t x)
+    {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    void put(uint8_t *&out, uint64_t value, int bytes)
+    {
+        for (int i = 0; i < bytes; i++) {
+            *out++ = (uint8_t)(value >> (8 * i));
+        }
+    }
+
+    uint64_t get(const uint8_t *&in, int bytes)
+    {
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; i++) {
+            value |= (uint64_t)*in++ << (8 * i);
+        }
+        return value;
+    }
+}
+
+uint64_t BoardSnapshot::hash() const
+{
+    uint64_t h = mix(((uint64_t)variant << 8) | sideToMove);
+    for (uint64_t plane : planes) {
+        h = mix(h ^ plane);
+    }
+    return h;
+}
+
+void BoardSnapshot::encode(uint8_t *out) const
+{
+    put(out, variant, 4);
+    put(out, sideToMove, 1);
+    for (uint64_t plane : planes) {
+        put(out, plane, 8);
+    }
+}
+
+bool BoardSnapshot::decode(const uint8_t *in)
+{
+    variant = (uint32_t)get(in, 4);
+    sideToMove = (uint8_t)get(in, 1);
+    for (uint64_t &plane : planes) {
+        plane = get(in, 8);
+    }
+    return variant != 0 && sideToMove < 2;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+//
+// fixed size binary position, the allocation free counterpart to a game's state string.
+// each game lays its pieces out as bitboards in planes and tags the layout with a variant,
+// so snapshots from different games (or board sizes) never compare equal or decode into
+// each other. the string form stays for display, history, caching and save files use this.
+//
+
+struct BoardSnapshot
+{
+    static const int kPlanes = 8;
+    // variant, side to move, then the planes, all little endian
+    static const size_t kEncodedSize = 4 + 1 + kPlanes * 8;
+
+    uint32_t    variant = 0;
+    uint8_t     sideToMove = 0;
+    std::array<uint64_t, kPlanes> planes = {};
+
+    // a game letter and up to three layout parameters, e.g. board width, height and k in a row
+    static constexpr uint32_t makeVariant(char game, int a = 0, int b = 0, int c = 0)
+    {
+        return (uint32_t)(uint8_t)game << 24 | (uint32_t)(a & 0xFF) << 16 | (uint32_t)(b & 0xFF) << 8 | (uint32_t)(c & 0xFF);
+    }
+
+    bool        test(int plane, int bit) const { return (planes[plane + bit / 64] >> (bit % 64)) & 1; }
+    void        set(int plane, int bit) { planes[plane + bit / 64] |= 1ull << (bit % 64); }
+    void        reset(int plane, int bit) { planes[plane + bit / 64] &= ~(1ull << (bit % 64)); }
+
+    // the same on every platform and every run, safe to keep in files
+    uint64_t    hash() const;
+
+    void        encode(uint8_t *out) const;
+    bool        decode(const uint8_t *in);
+
+    bool operator==(const BoardSnapshot &other) const = default;
+};
@@ -1,4 +1,7 @@
 #include "Checkers.h"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
 
 Checkers::Checkers() : Game() {
     _grid = new Grid(8, 8);
@@ -9,6 +12,7 @@ Checkers::Checkers() : Game() {
 }
 
 Checkers::~Checkers() {
+    cancelAISearch();
     delete _grid;
 }
 
@@ -38,11 +42,15 @@ void Checkers::setUpBoard() {
         }
     });
 
+    if (gameHasAI()) {
+        setAIPlayer(AI_PLAYER);
+    }
+
     startGame();
 }
 
 Bit* Checkers::createPiece(int pieceType) {
-    Bit* bit = new Bit();
+    Bit* bit = _bitPool.acquire();
     bool isRed = (pieceType == RED_PIECE || pieceType == RED_KING);
     bit->LoadTextureFromFile(isRed ? "red.png" : "yellow.png");
     bit->setOwner(getPlayerAt(isRed ? RED_PLAYER : YELLOW_PLAYER));
@@ -126,6 +134,9 @@ void Checkers::bitMovedFromTo(Bit &bit, BitHolder &src, BitHolder &dst) {
     int dstX = dstSquare->getColumn();
     int dstY = dstSquare->getRow();
 
+    // history step: from and to squares, the captured piece and whether this one promoted
+    uint32_t move = (uint32_t)CheckersBoard::squareIndex(srcX, srcY) | ((uint32_t)CheckersBoard::squareIndex(dstX, dstY) << 5);
+
     // Check for jump
     ChessSquare* jumped = nullptr;
     if (dstSquare == _grid->getFLFL(srcX, srcY)) jumped = _grid->getFL(srcX, srcY);
@@ -136,18 +147,21 @@ void Checkers::bitMovedFromTo(Bit &bit, BitHolder &src, BitHolder &dst) {
     if (jumped && jumped->bit()) {
         // Capture
         (jumped->bit()->getOwner() == getPlayerAt(RED_PLAYER)) ? _redPieces-- : _yellowPieces--;
+        move |= (uint32_t)jumped->bit()->gameTag() << 10;
         jumped->destroyBit();
 
         // Promotion check
         if ((bit.gameTag() == RED_PIECE && dstY == 7) || (bit.gameTag() == YELLOW_PIECE && dstY == 0)) {
             bit.setGameTag(bit.gameTag() == RED_PIECE ? RED_KING : YELLOW_KING);
             bit.setScale(1.3f);
+            move |= kMovePromoted;
         }
 
         // Check for more jumps
         if (canJumpFrom(*dstSquare)) {
             _mustContinueJumping = true;
             _jumpingPiece = &dst;
+            recordMove(move, true);
             return;
         }
     } else {
@@ -155,14 +169,153 @@ void Checkers::bitMovedFromTo(Bit &bit, BitHolder &src, BitHolder &dst) {
         if ((bit.gameTag() == RED_PIECE && dstY == 7) || (bit.gameTag() == YELLOW_PIECE && dstY == 0)) {
             bit.setGameTag(bit.gameTag() == RED_PIECE ? RED_KING : YELLOW_KING);
             bit.setScale(1.3f);
+            move |= kMovePromoted;
         }
     }
 
     _mustContinueJumping = false;
     _jumpingPiece = nullptr;
+    recordMove(move);
     endTurn();
 }
 
+void Checkers::applyMoveToSnapshot(BoardSnapshot &snapshot, uint32_t move) const {
+    if (snapshot.variant != kSnapshotVariant) return;
+    int from = move & 31;
+    int to = (move >> 5) & 31;
+    int plane = snapshot.test(kRedPlane, from) ? kRedPlane : kYellowPlane;
+    bool king = snapshot.test(kKingPlane, from) || (move & kMovePromoted);
+    snapshot.reset(plane, from);
+    snapshot.reset(kKingPlane, from);
+    snapshot.set(plane, to);
+    if (king) {
+        snapshot.set(kKingPlane, to);
+    }
+    if ((move >> 10) & 7) {
+        int fromX, fromY, toX, toY;
+        CheckersBoard::squareCoordinates(from, fromX, fromY);
+        CheckersBoard::squareCoordinates(to, toX, toY);
+        int jumped = CheckersBoard::squareIndex((fromX + toX) / 2, (fromY + toY) / 2);
+        snapshot.reset(kRedPlane, jumped);
+        snapshot.reset(kYellowPlane, jumped);
+        snapshot.reset(kKingPlane, jumped);
+    }
+    // a jump that has more to come keeps the same side moving, with the same piece
+    bool continues = (move & GameHistory::kTurnContinues) != 0;
+    snapshot.sideToMove = (uint8_t)((plane == kRedPlane) == continues ? RED_PLAYER : YELLOW_PLAYER);
+    snapshot.planes[kJumpingPlane] = 0;
+    if (continues) {
+        snapshot.set(kJumpingPlane, to);
+    }
+}
+
+BoardSnapshot Checkers::snapshot() {
+    CheckersBoard board = boardFromGrid(getCurrentPlayer() == getPlayerAt(RED_PLAYER));
+    BoardSnapshot snapshot;
+    snapshot.variant = kSnapshotVariant;
+    snapshot.sideToMove = board.redToMove ? RED_PLAYER : YELLOW_PLAYER;
+    snapshot.planes[kRedPlane] = board.red;
+    snapshot.planes[kYellowPlane] = board.yellow;
+    snapshot.planes[kKingPlane] = board.kings;
+    if (_mustContinueJumping && _jumpingPiece) {
+        ChessSquare* square = static_cast<ChessSquare*>(_jumpingPiece);
+        snapshot.set(kJumpingPlane, CheckersBoard::squareIndex(square->getColumn(), square->getRow()));
+    }
+    return snapshot;
+}
+
+bool Checkers::restoreSnapshot(const BoardSnapshot &snapshot) {
+    if (snapshot.variant != kSnapshotVariant) return false;
+    cancelAISearch();
+    _redPieces = 0;
+    _yellowPieces = 0;
+    _mustContinueJumping = false;
+    _jumpingPiece = nullptr;
+    _grid->forEachEnabledSquare([&](ChessSquare* square, int x, int y) {
+        int index = CheckersBoard::squareIndex(x, y);
+        bool king = snapshot.test(kKingPlane, index);
+        square->destroyBit();
+        int pieceType = EMPTY;
+        if (snapshot.test(kRedPlane, index)) {
+            pieceType = king ? RED_KING : RED_PIECE;
+            _redPieces++;
+        } else if (snapshot.test(kYellowPlane, index)) {
+            pieceType = king ? YELLOW_KING : YELLOW_PIECE;
+            _yellowPieces++;
+        }
+        if (pieceType != EMPTY) {
+            Bit* piece = createPiece(pieceType);
+            piece->setPosition(square->getPosition());
+            square->setBit(piece);
+        }
+        // the jumping piece has to finish its captures before the turn can pass
+        if (pieceType != EMPTY && snapshot.test(kJumpingPlane, index)) {
+            _mustContinueJumping = true;
+            _jumpingPiece = square;
+        }
+    });
+    return true;
+}
+
+//
+// history steps move the existing piece rather than rebuilding the board,
+// a capture brings back a fresh piece of the recorded type on undo
+//
+void Checkers::moveBitBetween(ChessSquare* src, ChessSquare* dst) {
+    Bit* bit = src->bit();
+    if (!bit) return;
+    // the destination takes the parent first so clearing the source doesn't free the piece
+    dst->setBit(bit);
+    bit->setPosition(dst->getPosition());
+    src->setBit(nullptr);
+}
+
+void Checkers::setJumpStateFrom(uint32_t move) {
+    _mustContinueJumping = (move & GameHistory::kTurnContinues) != 0;
+    _jumpingPiece = _mustContinueJumping ? squareForIndex((move >> 5) & 31) : nullptr;
+}
+
+void Checkers::applyMove(uint32_t move) {
+    cancelAISearch();
+    ChessSquare* src = squareForIndex(move & 31);
+    ChessSquare* dst = squareForIndex((move >> 5) & 31);
+    moveBitBetween(src, dst);
+    if ((move >> 10) & 7) {
+        ChessSquare* jumped = _grid->getSquare((src->getColumn() + dst->getColumn()) / 2, (src->getRow() + dst->getRow()) / 2);
+        int captured = (move >> 10) & 7;
+        (captured == RED_PIECE || captured == RED_KING) ? _redPieces-- : _yellowPieces--;
+        jumped->destroyBit();
+    }
+    Bit* bit = dst->bit();
+    if (bit && (move & kMovePromoted)) {
+        bit->setGameTag(bit->gameTag() == RED_PIECE ? RED_KING : YELLOW_KING);
+        bit->setScale(1.3f);
+    }
+    setJumpStateFrom(move);
+}
+
+void Checkers::unapplyMove(uint32_t move) {
+    cancelAISearch();
+    ChessSquare* src = squareForIndex(move & 31);
+    ChessSquare* dst = squareForIndex((move >> 5) & 31);
+    Bit* bit = dst->bit();
+    if (bit && (move & kMovePromoted)) {
+        bit->setGameTag(bit->gameTag() == RED_KING ? RED_PIECE : YELLOW_PIECE);
+        bit->setScale(1.0f);
+    }
+    moveBitBetween(dst, src);
+    if ((move >> 10) & 7) {
+        ChessSquare* jumped = _grid->getSquare((src->getColumn() + dst->getColumn()) / 2, (src->getRow() + dst->getRow()) / 2);
+        int captured = (move >> 10) & 7;
+        (captured == RED_PIECE || captured == RED_KING) ? _redPieces++ : _yellowPieces++;
+        Bit* piece = createPiece(captured);
+        piece->setPosition(jumped->getPosition());
+        jumped->setBit(piece);
+    }
+    // still mid jump if the move before this one continued the turn
+    setJumpStateFrom(_historyCursor > 0 ? _history.moveAt(_historyCursor - 1) : 0);
+}
+
 bool Checkers::canJumpFrom(ChessSquare& square) const {
     Bit* piece = square.bit();
     if (!piece) return false;
@@ -190,56 +343,46 @@ bool Checkers::canJumpFrom(ChessSquare& square) const {
 }
 
 bool Checkers::hasJumpAvailable(Player* player) const {
-    bool hasJump = false;
+    return boardFromGrid(player == getPlayerAt(RED_PLAYER)).hasCapture();
+}
+
+CheckersBoard Checkers::boardFromGrid(bool redToMove) const {
+    CheckersBoard board;
+    board.redToMove = redToMove;
     _grid->forEachEnabledSquare([&](ChessSquare* square, int x, int y) {
-        if (hasJump) return;
-        Bit* piece = square->bit();
-        if (piece && piece->getOwner() == player) {
-            Checkers* self = const_cast<Checkers*>(this);
-            if (self->canJumpFrom(*square)) {
-                hasJump = true;
-            }
+        Bit* bit = square->bit();
+        if (!bit) return;
+        uint32_t mask = 1u << CheckersBoard::squareIndex(x, y);
+        int tag = bit->gameTag();
+        ((tag == RED_PIECE || tag == RED_KING) ? board.red : board.yellow) |= mask;
+        if (tag == RED_KING || tag == YELLOW_KING) {
+            board.kings |= mask;
         }
     });
-    return hasJump;
+    return board;
+}
+
+void Checkers::legalMoves(CheckersMoveList &moves) const {
+    Checkers* self = const_cast<Checkers*>(this);
+    CheckersBoard board = boardFromGrid(self->getCurrentPlayer() == getPlayerAt(RED_PLAYER));
+    if (_mustContinueJumping && _jumpingPiece) {
+        ChessSquare* square = static_cast<ChessSquare*>(_jumpingPiece);
+        moves.clear();
+        board.generateJumpsFrom(CheckersBoard::squareIndex(square->getColumn(), square->getRow()), moves);
+        return;
+    }
+    board.generateMoves(moves);
 }
 
 Player* Checkers::checkForWinner() {
     if (_redPieces == 0) return getPlayerAt(YELLOW_PLAYER);
     if (_yellowPieces == 0) return getPlayerAt(RED_PLAYER);
 
-    // Check if current player has any moves
-    Player* current = getCurrentPlayer();
-    bool hasMove = false;
-
-    _grid->forEachEnabledSquare([&](ChessSquare* square, int x, int y) {
-        if (hasMove) return;
-        Bit* piece = square->bit();
-        if (piece && piece->getOwner() == current) {
-            bool isKing = (piece->gameTag() == RED_KING || piece->gameTag() == YELLOW_KING);
-            bool isRed = (current == getPlayerAt(RED_PLAYER));
-
-            // Check for any valid move
-            auto checkMove = [&](ChessSquare* target) {
-                if (target && !target->bit()) hasMove = true;
-            };
-
-            if (isKing) {
-                checkMove(_grid->getFL(x, y));
-                checkMove(_grid->getFR(x, y));
-                checkMove(_grid->getBL(x, y));
-                checkMove(_grid->getBR(x, y));
-            } else if (isRed) {
-                checkMove(_grid->getBL(x, y));
-                checkMove(_grid->getBR(x, y));
-            } else {
-                checkMove(_grid->getFL(x, y));
-                checkMove(_grid->getFR(x, y));
-            }
-        }
-    });
-
-    if (!hasMove) {
+    // the player to move loses if they have no legal move, captures included
+    CheckersMoveList moves;
+    legalMoves(moves);
+    if (moves.empty()) {
+        Player* current = getCurrentPlayer();
         return current == getPlayerAt(RED_PLAYER) ? getPlayerAt(YELLOW_PLAYER) : getPlayerAt(RED_PLAYER);
     }
     return nullptr;
@@ -250,6 +393,7 @@ bool Checkers::checkForDraw() {
 }
 
 void Checkers::stopGame() {
+    cancelAISearch();
     _grid->forEachSquare([](ChessSquare* square, int x, int y) {
         square->destroyBit();
     });
@@ -290,5 +434,82 @@ void Checkers::setStateString(const std::string &s) {
     });
 }
 
-void Checkers::updateAI() {}
+ChessSquare* Checkers::squareForIndex(int square) const {
+    int x, y;
+    CheckersBoard::squareCoordinates(square, x, y);
+    return _grid->getSquare(x, y);
+}
+
+//
+// the search runs on a worker thread so the board keeps drawing while it thinks.
+// each frame we either start a search, or check whether the running one has an answer.
+//
+void Checkers::updateAI() {
+    if (_aiSearch.valid()) {
+        if (_aiSearch.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return;
+        }
+        CheckersAI::Result result = _aiSearch.get();
+        if (result.found) {
+            playMove(result.move);
+        }
+        return;
+    }
+
+    CheckersMoveList moves;
+    legalMoves(moves);
+    if (moves.empty()) {
+        return;
+    }
+    CheckersBoard board = boardFromGrid(getCurrentPlayer() == getPlayerAt(RED_PLAYER));
+    _ai.clearStop();
+    _aiSearch = std::async(std::launch::async, [this, board, moves]() {
+        return _ai.search(board, moves, kAIMaxDepth, kAITimeLimitMs);
+    });
+}
+
+void Checkers::cancelAISearch() {
+    if (_aiSearch.valid()) {
+        _ai.stop();
+        _aiSearch.wait();
+        _aiSearch = {};
+    }
+}
+
+//
+// play a move one jump at a time through the same path a dragged piece takes,
+// so captures, promotion and continued jumps are handled by bitMovedFromTo.
+// the move is matched against the legal moves first, so no step can be turned down
+// halfway through a multi jump. the search only picks legal moves, a miss is a bug,
+// and release builds play the first legal move rather than leave the turn hanging
+//
+static bool sameMove(const CheckersMove &a, const CheckersMove &b) {
+    return a.from == b.from && a.pathLength == b.pathLength && std::equal(a.path, a.path + a.pathLength, b.path);
+}
+
+void Checkers::playMove(const CheckersMove &requested) {
+    CheckersMoveList moves;
+    legalMoves(moves);
+    if (moves.empty()) return;
+    const CheckersMove* move = std::find_if(moves.begin(), moves.end(), [&](const CheckersMove &legal) {
+        return sameMove(legal, requested);
+    });
+    if (move == moves.end()) {
+        assert(!"Checkers::playMove was handed an illegal move");
+        std::cout << "Checkers AI move from " << (int)requested.from << " is not legal, playing the first legal move" << std::endl;
+        move = moves.begin();
+    }
+
+    int from = move->from;
+    for (int i = 0; i < move->pathLength; i++) {
+        ChessSquare* src = squareForIndex(from);
+        ChessSquare* dst = squareForIndex(move->path[i]);
+        Bit* bit = src->bit();
+        assert(bit && canBitMoveFrom(*bit, *src) && canBitMoveFromTo(*bit, *src, *dst));
+        dst->dropBitAtPoint(bit, dst->getPosition());
+        src->draggedBitTo(bit, dst);
+        bitMovedFromTo(*bit, *src, *dst);
+        from = move->path[i];
+    }
+}
 
@@ -1,5 +1,7 @@
 #pragma once
 #include "Game.h"
+#include "CheckersBoard.h"
+#include "CheckersAI.h"
 
 // NOTE: If Square class needs modifications to support colored squares for checkerboard pattern,
 // add a method like setColor(ImVec4 color) to Square class
@@ -22,12 +24,20 @@ public:
     bool        canBitMoveFromTo(Bit &bit, BitHolder &src, BitHolder &dst) override;
     void        stopGame() override;
     void        bitMovedFromTo(Bit &bit, BitHolder &src, BitHolder &dst) override;
+    BoardSnapshot snapshot() override;
+    bool        restoreSnapshot(const BoardSnapshot &snapshot) override;
+    void        applyMoveToSnapshot(BoardSnapshot &snapshot, uint32_t move) const override;
 
     // AI methods
     void        updateAI() override;
-    bool        gameHasAI() override { return false; } // Set to true when AI is implemented
+    bool        aiSearchStats(SearchStats &stats) override { stats = _ai.stats(); return true; }
+    bool        gameHasAI() override { return true; }
     Grid* getGrid() override { return _grid; }
 
+protected:
+    void        applyMove(uint32_t move) override;
+    void        unapplyMove(uint32_t move) override;
+
 private:
     // Constants for piece types
     static const int EMPTY = 0;
@@ -36,12 +46,25 @@ private:
     static const int YELLOW_PIECE = 3;
     static const int YELLOW_KING = 4;
 
+    // history step flags, the captured piece type sits in bits 10-12
+    static const uint32_t kMovePromoted = 1u << 13;
+
+    // snapshot planes: red pieces, yellow pieces, kings, by square number, and the square of
+    // a piece that is partway through a multi jump and has to keep capturing
+    static constexpr uint32_t kSnapshotVariant = BoardSnapshot::makeVariant('C', 8, 8);
+    static const int kRedPlane = 0;
+    static const int kYellowPlane = 1;
+    static const int kKingPlane = 2;
+    static const int kJumpingPlane = 3;
+
     // Player constants
     static const int RED_PLAYER = 0;
     static const int YELLOW_PLAYER = 1;
 
     // Helper methods
     Bit*        createPiece(int pieceType);
+    void        moveBitBetween(ChessSquare* src, ChessSquare* dst);
+    void        setJumpStateFrom(uint32_t move);
     int         getPieceType(const Bit& bit) const;
     bool        isKing(const Bit& bit) const;
     bool        isValidMove(int srcX, int srcY, int dstX, int dstY, Player* player) const;
@@ -53,6 +76,16 @@ private:
     void        getBoardPosition(BitHolder &holder, int &x, int &y) const;
     bool        isValidSquare(int x, int y) const;
 
+    // bitboard snapshot of the grid, used for full move generation
+    CheckersBoard boardFromGrid(bool redToMove) const;
+    // every legal move for the current player, honoring a jump that is still in progress
+    void        legalMoves(CheckersMoveList &moves) const;
+    ChessSquare* squareForIndex(int square) const;
+
+    // AI helpers
+    void        playMove(const CheckersMove &requested);
+    void        cancelAISearch();
+
     // Board representation
     Grid*        _grid;
 
@@ -61,4 +94,10 @@ private:
     BitHolder*  _jumpingPiece;
     int         _redPieces;
     int         _yellowPieces;
+
+    // the AI searches on a worker thread, updateAI polls for the answer each frame
+    CheckersAI  _ai;
+    std::future<CheckersAI::Result> _aiSearch;
+    static const int kAIMaxDepth = 24;
+    static const int kAITimeLimitMs = 750;
 };
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include "CheckersAI.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <random>
+
+namespace {
+
+// zobrist keys for the four piece kinds on each square plus the side to move
+struct ZobristKeys
+{
+    uint64_t pieces[CheckersBoard::kSquares][4];
+    uint64_t redToMove;
+
+    ZobristKeys()
+    {
+        std::mt19937_64 rng(0x6368656b657273ull);
+        for (auto &square : pieces) {
+            for (auto &key : square) {
+                key = rng();
+            }
+        }
+        redToMove = rng();
+    }
+};
+
+const ZobristKeys &zobrist()
+{
+    static const ZobristKeys keys;
+    return keys;
+}
+
+// material and positional weights
+const int kManValue = 100;
+const int kKingValue = 160;
+const int kAdvanceBonus = 3;      // per row a man has moved towards promotion
+const int kBackRankBonus = 8;     // men still guarding their own back row
+const int kCenterKingBonus = 6;   // kings on the four central squares
+const uint32_t kCenterSquares = 0x00066000u;
+const uint32_t kRedBackRow = CheckersBoard::kYellowPromotionRow;
+const uint32_t kYellowBackRow = CheckersBoard::kRedPromotionRow;
+
+// captures that take more pieces first, then promotions
+int movePriority(const CheckersMove &move)
+{
+    return std::popcount(move.captured) * 4 + (move.promotes ? 1 : 0);
+}
+
+} // namespace
+
+CheckersAI::CheckersAI() : _tablebase(CheckersTablebase::shared())
+{
+}
+
+CheckersAI::Position::Position(const CheckersBoard &board, const CheckersTablebase &tablebase, int probeLimit)
+    : _tablebase(tablebase), _probeLimit(probeLimit)
+{
+    _boards[0] = board;
+}
+
+//
+// generation order with the biggest captures and promotions moved up. the engine keeps the
+// table's best move as an index into this, which stays valid as the sort is stable
+//
+int CheckersAI::Position::generateMoves(Move *moves) const
+{
+    CheckersMoveList list;
+    board().generateMoves(list);
+    int count = list.size();
+    std::copy(list.begin(), list.end(), moves);
+    std::stable_sort(moves, moves + count, [](const Move &a, const Move &b) { return movePriority(a) > movePriority(b); });
+    return count;
+}
+
+void CheckersAI::Position::play(const Move &move)
+{
+    _boards[_ply + 1] = _boards[_ply];
+    _boards[++_ply].makeMove(move);
+}
+
+bool CheckersAI::Position::probe(int, int &score) const
+{
+    const CheckersBoard &current = board();
+    if (current.pieceCount() > _probeLimit) {
+        return false;
+    }
+    // the evaluation is added on top so a won ending still heads for more material
+    switch (_tablebase.probe(current)) {
+    case CheckersTablebase::kWin: score = kTablebaseWin + CheckersAI::evaluate(current); return true;
+    case CheckersTablebase::kLoss: score = -kTablebaseWin + CheckersAI::evaluate(current); return true;
+    case CheckersTablebase::kDraw: score = 0; return true;
+    default: return false;
+    }
+}
+
+uint64_t CheckersAI::hash(const CheckersBoard &board)
+{
+    const ZobristKeys &keys = zobrist();
+    uint64_t key = board.redToMove ? keys.redToMove : 0;
+    for (uint32_t pieces = board.occupied(); pieces; pieces &= pieces - 1) {
+        int square = std::countr_zero(pieces);
+        uint32_t mask = 1u << square;
+        int kind = ((board.yellow & mask) ? 2 : 0) + ((board.kings & mask) ? 1 : 0);
+        key ^= keys.pieces[square][kind];
+    }
+    return key;
+}
+
+int CheckersAI::evaluate(const CheckersBoard &board)
+{
+    auto sideScore = [&](uint32_t pieces, bool red, uint32_t opponentMen) {
+        uint32_t men = pieces & ~board.kings;
+        uint32_t kings = pieces & board.kings;
+        int score = std::popcount(men) * kManValue + std::popcount(kings) * kKingValue;
+        for (uint32_t m = men; m; m &= m - 1) {
+            int row = std::countr_zero(m) / 4;
+            score += kAdvanceBonus * (red ? row : 7 - row);
+        }
+        // the back row only matters while the other side still has men that could promote
+        if (opponentMen) {
+            score += kBackRankBonus * std::popcount(men & (red ? kRedBackRow : kYellowBackRow));
+        }
+        score += kCenterKingBonus * std::popcount(kings & kCenterSquares);
+        return score;
+    };
+    int redScore = sideScore(board.red, true, board.yellow & ~board.kings);
+    int yellowScore = sideScore(board.yellow, false, board.red & ~board.kings);
+    return board.redToMove ? redScore - yellowScore : yellowScore - redScore;
+}
+
+bool CheckersAI::filterByTablebase(const CheckersBoard &board, const CheckersMoveList &rootMoves, CheckersMoveList &kept)
+{
+    _probeLimit = _tablebase.maxPieces();
+    CheckersTablebase::Value rootValue = CheckersTablebase::kUnknown;
+    if (board.pieceCount() <= _probeLimit) {
+        rootValue = _tablebase.probe(board);
+    }
+    if (rootValue != CheckersTablebase::kWin && rootValue != CheckersTablebase::kDraw) {
+        return false;
+    }
+
+    _probeLimit = 0;
+    CheckersTablebase::Value wanted = rootValue == CheckersTablebase::kWin ? CheckersTablebase::kLoss : CheckersTablebase::kDraw;
+    kept.clear();
+    for (const CheckersMove &move : rootMoves) {
+        CheckersBoard child = board;
+        child.makeMove(move);
+        if (_tablebase.probe(child) == wanted) {
+            kept.push(move);
+        }
+    }
+    return !kept.empty();
+}
+
+CheckersAI::Result CheckersAI::search(const CheckersBoard &board, const CheckersMoveList &rootMoves, int maxDepth, int timeLimitMs)
+{
+    PROFILE_SCOPE("CheckersAI::search");
+    Result result;
+    if (rootMoves.empty()) {
+        return result;
+    }
+
+    //
+    // the tables only say won, lost or drawn, so once the root itself is in them cutting the
+    // search off at every probe would leave no way to tell progress from shuffling. keep the
+    // moves that hold the table result and let the normal search pick between those.
+    //
+    CheckersMoveList tableMoves;
+    const CheckersMoveList &moves = filterByTablebase(board, rootMoves, tableMoves) ? tableMoves : rootMoves;
+
+    // the root gets the same capture first order as the rest of the tree
+    CheckersMove ordered[CheckersMoveList::kMaxMoves];
+    std::copy(moves.begin(), moves.end(), ordered);
+    std::stable_sort(ordered, ordered + moves.size(), [](const CheckersMove &a, const CheckersMove &b) { return movePriority(a) > movePriority(b); });
+
+    Position position(board, _tablebase, _probeLimit);
+    AlphaBeta<Position>::Result found = _engine.search(position, ordered, moves.size(), maxDepth, timeLimitMs);
+    result.move = found.move;
+    result.score = found.score;
+    result.depth = found.depth;
+    result.nodes = found.nodes;
+    result.found = found.found;
+    return result;
+}
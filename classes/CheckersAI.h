@@ -0,0 +1,92 @@
+#pragma once
+
+#include "AlphaBeta.h"
+#include "CheckersBoard.h"
+#include "CheckersTablebase.h"
+#include "SearchStats.h"
+#include <cstdint>
+
+//
+// negamax alpha-beta searcher for checkers, on the shared AlphaBeta engine
+// iterative deepening with a transposition table, and a capture extension at the horizon
+// so a line never stops in the middle of an exchange. captures are mandatory in checkers,
+// so when the side to move can capture the only legal moves are captures and those are
+// searched out instead of trusting the static evaluation.
+// once few enough pieces are left the endgame tables answer exactly, when they are installed.
+//
+
+class CheckersAI
+{
+public:
+    struct Result
+    {
+        CheckersMove    move;
+        int             score = 0;
+        int             depth = 0;
+        uint64_t        nodes = 0;
+        bool            found = false;
+    };
+
+    static const int kWinScore = 30000;
+    // tablebase wins sit below the mate range, they are known won but not how quickly
+    static const int kTablebaseWin = 15000;
+
+    CheckersAI();
+
+    // search the position for up to maxDepth plies or timeLimitMs milliseconds, whichever is first.
+    // rootMoves are the moves to choose between, normally board.generateMoves() but a jump in
+    // progress restricts them to the moving piece.
+    Result      search(const CheckersBoard &board, const CheckersMoveList &rootMoves, int maxDepth, int timeLimitMs);
+    // ask a running search to return as soon as possible, the request sticks until clearStop
+    void        stop() { _engine.stop(); }
+    void        clearStop() { _engine.clearStop(); }
+    // counters of the running or last search, safe to call from any thread
+    SearchStats stats() const { return _engine.stats(); }
+
+    // static evaluation from the point of view of the side to move
+    static int  evaluate(const CheckersBoard &board);
+    static uint64_t hash(const CheckersBoard &board);
+
+private:
+    //
+    // the board as the engine sees it. CheckersBoard has no unmake, so every ply keeps the
+    // board it came from and undo just steps back to it
+    //
+    class Position
+    {
+    public:
+        using Move = CheckersMove;
+        static const int kMaxMoves = CheckersMoveList::kMaxMoves;
+        static const int kWinScore = CheckersAI::kWinScore;
+        static const int kMoveKeys = CheckersBoard::kSquares * CheckersBoard::kSquares;
+
+        Position(const CheckersBoard &board, const CheckersTablebase &tablebase, int probeLimit);
+
+        int         generateMoves(Move *moves) const;
+        void        play(const Move &move);
+        void        undo(const Move &) { _ply--; }
+        int         evaluate() const { return CheckersAI::evaluate(board()); }
+        uint64_t    hash() const { return CheckersAI::hash(board()); }
+        bool        terminal(int, int &) const { return false; }
+        // no legal move loses, sooner is worse
+        int         noMovesScore(int ply) const { return -(kWinScore - ply); }
+        int         moveKey(const Move &move) const { return move.from * CheckersBoard::kSquares + move.to; }
+        // at the horizon only quiet positions are evaluated, captures get searched out
+        bool        isQuiet(const Move *moves, int count) const { return count == 0 || !moves[0].isCapture(); }
+        bool        probe(int ply, int &score) const;
+
+    private:
+        const CheckersBoard &board() const { return _boards[_ply]; }
+
+        CheckersBoard           _boards[kAlphaBetaMaxPly + 1];
+        int                     _ply = 0;
+        const CheckersTablebase &_tablebase;
+        int                     _probeLimit;
+    };
+
+    bool        filterByTablebase(const CheckersBoard &board, const CheckersMoveList &rootMoves, CheckersMoveList &kept);
+
+    AlphaBeta<Position>     _engine;
+    const CheckersTablebase &_tablebase;
+    int                     _probeLimit = 0;    // probe positions with at most this many pieces
+};
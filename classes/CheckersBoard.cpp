@@ -0,0 +1,247 @@
+#include "CheckersBoard.h"
+
+namespace {
+
+//
+// neighbour and jump tables, built once at compile time
+//
+struct DiagonalTables
+{
+    int neighbor[CheckersBoard::kSquares][4];
+    int jump[CheckersBoard::kSquares][4];
+};
+
+constexpr int kDirectionX[4] = {-1, 1, -1, 1};
+constexpr int kDirectionY[4] = {-1, -1, 1, 1};
+
+constexpr int indexFor(int x, int y)
+{
+    if (x < 0 || x > 7 || y < 0 || y > 7 || (x + y) % 2 == 0) {
+        return -1;
+    }
+    return y * 4 + x / 2;
+}
+
+constexpr DiagonalTables buildTables()
+{
+    DiagonalTables tables{};
+    for (int square = 0; square < CheckersBoard::kSquares; square++) {
+        int y = square / 4;
+        int x = (square % 4) * 2 + (y % 2 == 0 ? 1 : 0);
+        for (int dir = 0; dir < 4; dir++) {
+            tables.neighbor[square][dir] = indexFor(x + kDirectionX[dir], y + kDirectionY[dir]);
+            tables.jump[square][dir] = indexFor(x + 2 * kDirectionX[dir], y + 2 * kDirectionY[dir]);
+        }
+    }
+    return tables;
+}
+
+constexpr DiagonalTables kTables = buildTables();
+
+// red men move towards y = 7, yellow men towards y = 0, kings either way
+constexpr int kRedManDirections[] = {CheckersBoard::kBackLeft, CheckersBoard::kBackRight};
+constexpr int kYellowManDirections[] = {CheckersBoard::kFrontLeft, CheckersBoard::kFrontRight};
+constexpr int kKingDirections[] = {CheckersBoard::kFrontLeft, CheckersBoard::kFrontRight, CheckersBoard::kBackLeft, CheckersBoard::kBackRight};
+
+struct DirectionSet
+{
+    const int *dirs;
+    int count;
+};
+
+inline DirectionSet directionsFor(bool king, bool red)
+{
+    if (king) {
+        return {kKingDirections, 4};
+    }
+    return red ? DirectionSet{kRedManDirections, 2} : DirectionSet{kYellowManDirections, 2};
+}
+
+inline uint32_t bit(int square) { return 1u << square; }
+
+} // namespace
+
+int CheckersBoard::squareIndex(int x, int y)
+{
+    return indexFor(x, y);
+}
+
+void CheckersBoard::squareCoordinates(int square, int &x, int &y)
+{
+    y = square / 4;
+    x = (square % 4) * 2 + (y % 2 == 0 ? 1 : 0);
+}
+
+int CheckersBoard::neighbor(int square, int direction)
+{
+    return kTables.neighbor[square][direction];
+}
+
+int CheckersBoard::jumpLanding(int square, int direction)
+{
+    return kTables.jump[square][direction];
+}
+
+//
+// can the piece on square capture anything right now
+//
+bool CheckersBoard::canJumpFrom(int square) const
+{
+    uint32_t mask = bit(square);
+    bool isRed = (red & mask) != 0;
+    if (!isRed && !(yellow & mask)) {
+        return false;
+    }
+    uint32_t theirs = isRed ? yellow : red;
+    uint32_t empty = ~occupied();
+    DirectionSet set = directionsFor((kings & mask) != 0, isRed);
+    for (int i = 0; i < set.count; i++) {
+        int middle = kTables.neighbor[square][set.dirs[i]];
+        int landing = kTables.jump[square][set.dirs[i]];
+        if (landing >= 0 && (theirs & bit(middle)) && (empty & bit(landing))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CheckersBoard::hasCapture() const
+{
+    for (uint32_t pieces = sideToMove(); pieces; pieces &= pieces - 1) {
+        if (canJumpFrom(std::countr_zero(pieces))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//
+// depth first walk of a jump sequence. captured pieces come off the board as they are jumped
+// (the same as Checkers::bitMovedFromTo) and a man that lands on its promotion row carries on
+// as a king, so the sequences here are exactly the ones the UI will let a player make.
+//
+void CheckersBoard::addJumps(int from, int square, bool king, uint32_t capturedSoFar, CheckersMove &current, CheckersMoveList &moves) const
+{
+    bool isRed = (red & bit(from)) != 0;
+    uint32_t theirs = (isRed ? yellow : red) & ~capturedSoFar;
+    uint32_t blocked = (occupied() & ~capturedSoFar & ~bit(from));
+    bool extended = false;
+
+    DirectionSet set = directionsFor(king, isRed);
+    for (int i = 0; i < set.count && current.pathLength < CheckersMove::kMaxPath; i++) {
+        int middle = kTables.neighbor[square][set.dirs[i]];
+        int landing = kTables.jump[square][set.dirs[i]];
+        if (landing < 0 || !(theirs & bit(middle)) || (blocked & bit(landing))) {
+            continue;
+        }
+        extended = true;
+        bool promotes = !king && (bit(landing) & (isRed ? kRedPromotionRow : kYellowPromotionRow));
+        current.path[current.pathLength++] = (uint8_t)landing;
+        bool wasPromoting = current.promotes;
+        current.promotes = current.promotes || promotes;
+        addJumps(from, landing, king || promotes, capturedSoFar | bit(middle), current, moves);
+        current.promotes = wasPromoting;
+        current.pathLength--;
+    }
+
+    if (!extended && current.pathLength > 0) {
+        current.to = (uint8_t)square;
+        current.captured = capturedSoFar;
+        moves.push(current);
+    }
+}
+
+void CheckersBoard::generateJumpsFrom(int square, CheckersMoveList &moves) const
+{
+    CheckersMove current;
+    current.from = (uint8_t)square;
+    addJumps(square, square, (kings & bit(square)) != 0, 0, current, moves);
+}
+
+void CheckersBoard::generateMoves(CheckersMoveList &moves) const
+{
+    moves.clear();
+
+    // captures are mandatory
+    for (uint32_t pieces = sideToMove(); pieces; pieces &= pieces - 1) {
+        int square = std::countr_zero(pieces);
+        if (canJumpFrom(square)) {
+            generateJumpsFrom(square, moves);
+        }
+    }
+    if (!moves.empty()) {
+        return;
+    }
+
+    uint32_t empty = ~occupied();
+    uint32_t promotionRow = redToMove ? kRedPromotionRow : kYellowPromotionRow;
+    for (uint32_t pieces = sideToMove(); pieces; pieces &= pieces - 1) {
+        int square = std::countr_zero(pieces);
+        bool king = (kings & bit(square)) != 0;
+        DirectionSet set = directionsFor(king, redToMove);
+        for (int i = 0; i < set.count; i++) {
+            int target = kTables.neighbor[square][set.dirs[i]];
+            if (target < 0 || !(empty & bit(target))) {
+                continue;
+            }
+            CheckersMove move;
+            move.from = (uint8_t)square;
+            move.to = (uint8_t)target;
+            move.pathLength = 1;
+            move.path[0] = (uint8_t)target;
+            move.promotes = !king && (bit(target) & promotionRow);
+            moves.push(move);
+        }
+    }
+}
+
+void CheckersBoard::makeMove(const CheckersMove &move)
+{
+    uint32_t &mine = redToMove ? red : yellow;
+    uint32_t &theirs = redToMove ? yellow : red;
+    bool king = (kings & bit(move.from)) != 0;
+
+    mine &= ~bit(move.from);
+    kings &= ~bit(move.from);
+    theirs &= ~move.captured;
+    kings &= ~move.captured;
+
+    mine |= bit(move.to);
+    if (king || move.promotes) {
+        kings |= bit(move.to);
+    }
+    redToMove = !redToMove;
+}
+
+//
+// piece digits are the Checkers game tags: 1 red, 2 red king, 3 yellow, 4 yellow king
+//
+CheckersBoard CheckersBoard::fromStateString(const std::string &state, bool redToMove)
+{
+    CheckersBoard board;
+    board.redToMove = redToMove;
+    for (int square = 0; square < kSquares && square < (int)state.length(); square++) {
+        switch (state[square]) {
+        case '1': board.red |= bit(square); break;
+        case '2': board.red |= bit(square); board.kings |= bit(square); break;
+        case '3': board.yellow |= bit(square); break;
+        case '4': board.yellow |= bit(square); board.kings |= bit(square); break;
+        default: break;
+        }
+    }
+    return board;
+}
+
+std::string CheckersBoard::toStateString() const
+{
+    std::string state(kSquares, '0');
+    for (int square = 0; square < kSquares; square++) {
+        bool king = (kings & bit(square)) != 0;
+        if (red & bit(square)) {
+            state[square] = king ? '2' : '1';
+        } else if (yellow & bit(square)) {
+            state[square] = king ? '4' : '3';
+        }
+    }
+    return state;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <string>
+
+//
+// compact checkers position for move generation and search
+// the 32 playable (dark) squares are numbered in the same row-major order the grid uses
+// for its state string: square = y * 4 + x / 2, so red starts on 0..11 and yellow on 20..31.
+// red moves down the board (towards y = 7) and moves first.
+//
+
+struct CheckersMove
+{
+    static const int kMaxPath = 12;
+
+    uint8_t     from = 0;
+    uint8_t     to = 0;
+    uint8_t     pathLength = 0;          // landing squares, 1 for a simple move
+    bool        promotes = false;
+    uint32_t    captured = 0;            // bitmask of jumped squares
+    uint8_t     path[kMaxPath] = {};
+
+    bool        isCapture() const { return captured != 0; }
+};
+
+//
+// fixed capacity move buffer so move generation never touches the heap.
+// a side never has more than 12 pieces, so there are at most 12 * 4 = 48 plain moves. captures
+// come instead of those, and every jump stays on one of four lattices of 8 landing squares and
+// 9 squares jumped over, so walking every way 12 pieces and 12 opponents can sit on them puts
+// the jump sequences at 20 at most. 96 is twice the real bound, running out means a bug.
+//
+class CheckersMoveList
+{
+public:
+    static const int kMaxMoves = 96;
+
+    void                clear() { _count = 0; }
+    int                 size() const { return _count; }
+    bool                empty() const { return _count == 0; }
+    CheckersMove       &operator[](int i) { return _moves[i]; }
+    const CheckersMove &operator[](int i) const { return _moves[i]; }
+    CheckersMove       *begin() { return _moves.data(); }
+    CheckersMove       *end() { return _moves.data() + _count; }
+    const CheckersMove *begin() const { return _moves.data(); }
+    const CheckersMove *end() const { return _moves.data() + _count; }
+    void                push(const CheckersMove &move)
+    {
+        assert(_count < kMaxMoves);
+        _moves[_count++] = move;
+    }
+
+private:
+    std::array<CheckersMove, kMaxMoves> _moves;
+    int _count = 0;
+};
+
+struct CheckersBoard
+{
+    // diagonal directions, matching Grid::getFL / getFR / getBL / getBR
+    enum Direction
+    {
+        kFrontLeft,
+        kFrontRight,
+        kBackLeft,
+        kBackRight
+    };
+
+    static const int kSquares = 32;
+    static const uint32_t kRedPromotionRow = 0xF0000000u;     // y == 7
+    static const uint32_t kYellowPromotionRow = 0x0000000Fu;  // y == 0
+
+    uint32_t    red = 0;
+    uint32_t    yellow = 0;
+    uint32_t    kings = 0;
+    bool        redToMove = true;
+
+    // square numbering helpers, squareIndex returns -1 for light squares
+    static int  squareIndex(int x, int y);
+    static void squareCoordinates(int square, int &x, int &y);
+    // precomputed neighbour and jump landing tables, -1 when off the board
+    static int  neighbor(int square, int direction);
+    static int  jumpLanding(int square, int direction);
+
+    uint32_t    occupied() const { return red | yellow; }
+    uint32_t    sideToMove() const { return redToMove ? red : yellow; }
+    uint32_t    opponent() const { return redToMove ? yellow : red; }
+    int         pieceCount() const { return std::popcount(red | yellow); }
+
+    // the complete legal move list for the side to move: when any capture exists only
+    // captures are returned, and every capture is followed to the end of its jump sequence
+    void        generateMoves(CheckersMoveList &moves) const;
+    // the remaining jump sequences for a piece that is part way through a multi-jump
+    void        generateJumpsFrom(int square, CheckersMoveList &moves) const;
+    bool        hasCapture() const;
+    bool        canJumpFrom(int square) const;
+
+    // play a move in place and pass the turn
+    void        makeMove(const CheckersMove &move);
+
+    // same format as Checkers::stateString, 32 digits of piece types
+    static CheckersBoard fromStateString(const std::string &state, bool redToMove);
+    std::string toStateString() const;
+
+    bool        operator==(const CheckersBoard &other) const = default;
+
+private:
+    void        addJumps(int from, int square, bool king, uint32_t capturedSoFar, CheckersMove &current, CheckersMoveList &moves) const;
+};
@@ -0,0 +1,706 @@
+#include "CheckersTablebase.h"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char kMagic[4] = {'C', 'K', 'T', 'B'};
+const uint32_t kFileVersion = 1;
+
+struct FileHeader
+{
+    char        magic[4];
+    uint32_t    version;
+    uint32_t    maxPieces;
+    uint32_t    sliceCount;
+};
+
+struct FileSlice
+{
+    uint8_t     redMen;
+    uint8_t     redKings;
+    uint8_t     yellowMen;
+    uint8_t     yellowKings;
+    uint32_t    reserved;
+    uint64_t    offset;
+    uint64_t    positions;
+};
+
+// binomial coefficients for ranking piece placements
+struct Binomials
+{
+    uint64_t c[33][33] = {};
+
+    Binomials()
+    {
+        for (int n = 0; n <= 32; n++) {
+            c[n][0] = 1;
+            for (int k = 1; k <= n; k++) {
+                c[n][k] = c[n - 1][k - 1] + (k <= n - 1 ? c[n - 1][k] : 0);
+            }
+        }
+    }
+};
+
+const Binomials &binomials()
+{
+    static const Binomials table;
+    return table;
+}
+
+inline uint64_t choose(int n, int k)
+{
+    if (k < 0 || n < 0 || k > n) return 0;
+    return binomials().c[n][k];
+}
+
+// rotating the board 180 degrees maps dark square s to 31 - s, which is a bit reversal
+inline uint32_t reverseBits(uint32_t v)
+{
+    v = ((v >> 1) & 0x55555555u) | ((v & 0x55555555u) << 1);
+    v = ((v >> 2) & 0x33333333u) | ((v & 0x33333333u) << 2);
+    v = ((v >> 4) & 0x0F0F0F0Fu) | ((v & 0x0F0F0F0Fu) << 4);
+    v = ((v >> 8) & 0x00FF00FFu) | ((v & 0x00FF00FFu) << 8);
+    return (v >> 16) | (v << 16);
+}
+
+inline CheckersBoard flipped(const CheckersBoard &board)
+{
+    CheckersBoard result;
+    result.red = reverseBits(board.yellow);
+    result.yellow = reverseBits(board.red);
+    result.kings = reverseBits(board.kings);
+    result.redToMove = !board.redToMove;
+    return result;
+}
+
+// groups in the order they are ranked: red men, red kings, yellow men, yellow kings
+inline void groupMasks(const CheckersBoard &board, uint32_t masks[4])
+{
+    masks[0] = board.red & ~board.kings;
+    masks[1] = board.red & board.kings;
+    masks[2] = board.yellow & ~board.kings;
+    masks[3] = board.yellow & board.kings;
+}
+
+} // namespace
+
+CheckersTablebase::~CheckersTablebase()
+{
+    close();
+}
+
+CheckersTablebase &CheckersTablebase::shared()
+{
+    static CheckersTablebase tablebase;
+    static bool tried = false;
+    if (!tried) {
+        tried = true;
+        tablebase.open(defaultPath());
+    }
+    return tablebase;
+}
+
+CheckersBoard CheckersTablebase::canonical(const CheckersBoard &board)
+{
+    return board.redToMove ? board : flipped(board);
+}
+
+CheckersTablebase::SliceKey CheckersTablebase::keyFor(const CheckersBoard &board)
+{
+    uint32_t masks[4];
+    groupMasks(board, masks);
+    SliceKey key;
+    key.redMen = (uint8_t)std::popcount(masks[0]);
+    key.redKings = (uint8_t)std::popcount(masks[1]);
+    key.yellowMen = (uint8_t)std::popcount(masks[2]);
+    key.yellowKings = (uint8_t)std::popcount(masks[3]);
+    return key;
+}
+
+uint64_t CheckersTablebase::sliceSize(const SliceKey &key)
+{
+    int counts[4] = {key.redMen, key.redKings, key.yellowMen, key.yellowKings};
+    uint64_t size = 1;
+    int free = CheckersBoard::kSquares;
+    for (int count : counts) {
+        size *= choose(free, count);
+        free -= count;
+    }
+    return size;
+}
+
+//
+// each group is ranked as a combination of the squares the earlier groups left free,
+// and the four ranks are combined as a mixed radix number
+//
+uint64_t CheckersTablebase::indexOf(const CheckersBoard &board, const SliceKey &key)
+{
+    uint32_t masks[4];
+    groupMasks(board, masks);
+    uint32_t taken = 0;
+    int free = CheckersBoard::kSquares;
+    uint64_t index = 0;
+    for (int group = 0; group < 4; group++) {
+        uint64_t rank = 0;
+        int i = 0;
+        for (uint32_t m = masks[group]; m; m &= m - 1, i++) {
+            int square = std::countr_zero(m);
+            int compressed = square - std::popcount(taken & ((1u << square) - 1));
+            rank += choose(compressed, i + 1);
+        }
+        int count = std::popcount(masks[group]);
+        index = index * choose(free, count) + rank;
+        taken |= masks[group];
+        free -= count;
+    }
+    return index;
+}
+
+//
+// inverse of indexOf, returns false for placements that can't happen in a game
+// (a man standing on the row it would have promoted on)
+//
+bool CheckersTablebase::boardAt(const SliceKey &key, uint64_t index, CheckersBoard &board)
+{
+    int counts[4] = {key.redMen, key.redKings, key.yellowMen, key.yellowKings};
+    uint64_t radix[4];
+    int free = CheckersBoard::kSquares;
+    for (int group = 0; group < 4; group++) {
+        radix[group] = choose(free, counts[group]);
+        free -= counts[group];
+    }
+    uint64_t ranks[4];
+    for (int group = 3; group >= 0; group--) {
+        ranks[group] = index % radix[group];
+        index /= radix[group];
+    }
+
+    uint32_t masks[4] = {};
+    uint32_t taken = 0;
+    for (int group = 0; group < 4; group++) {
+        uint64_t rank = ranks[group];
+        for (int i = counts[group]; i > 0; i--) {
+            // largest compressed slot c with choose(c, i) <= rank
+            int c = i - 1;
+            while (choose(c + 1, i) <= rank) {
+                c++;
+            }
+            rank -= choose(c, i);
+            // expand the compressed slot back to a real square, skipping taken ones
+            int square = 0;
+            for (int seen = -1;; square++) {
+                if (!(taken & (1u << square)) && ++seen == c) {
+                    break;
+                }
+            }
+            masks[group] |= 1u << square;
+        }
+        taken |= masks[group];
+    }
+
+    board.red = masks[0] | masks[1];
+    board.yellow = masks[2] | masks[3];
+    board.kings = masks[1] | masks[3];
+    board.redToMove = true;
+    return !(masks[0] & CheckersBoard::kRedPromotionRow) && !(masks[2] & CheckersBoard::kYellowPromotionRow);
+}
+
+void CheckersTablebase::buildLookup()
+{
+    const int base = kMaxSupportedPieces + 1;
+    _lookup.assign(base * base * base * base, -1);
+    for (int i = 0; i < (int)_slices.size(); i++) {
+        const SliceKey &key = _slices[i].key;
+        _lookup[((key.redMen * base + key.redKings) * base + key.yellowMen) * base + key.yellowKings] = i;
+    }
+}
+
+const CheckersTablebase::Slice *CheckersTablebase::findSlice(const SliceKey &key) const
+{
+    const int base = kMaxSupportedPieces + 1;
+    if (key.redMen >= base || key.redKings >= base || key.yellowMen >= base || key.yellowKings >= base) {
+        return nullptr;
+    }
+    int slice = _lookup[((key.redMen * base + key.redKings) * base + key.yellowMen) * base + key.yellowKings];
+    return slice >= 0 ? &_slices[slice] : nullptr;
+}
+
+CheckersTablebase::Value CheckersTablebase::probe(const CheckersBoard &board) const
+{
+    CheckersBoard b = canonical(board);
+    // a side with nothing left has lost
+    if (!b.red) return kLoss;
+    if (!b.yellow) return kWin;
+    if (b.pieceCount() > _maxPieces) return kUnknown;
+
+    SliceKey key = keyFor(b);
+    const Slice *slice = findSlice(key);
+    if (!slice) {
+        return kUnknown;
+    }
+    return readValue(slice->data, indexOf(b, key));
+}
+
+// ---- file mapping ----
+
+bool CheckersTablebase::open(const std::string &path)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    _mapped = (const uint8_t *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    _mappedSize = (size_t)size.QuadPart;
+    _fileHandle = file;
+    _mappingHandle = mapping;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    void *mapped = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    _mapped = (const uint8_t *)mapped;
+    _mappedSize = (size_t)info.st_size;
+#endif
+
+    if (!_mapped || _mappedSize < sizeof(FileHeader)) {
+        close();
+        return false;
+    }
+    FileHeader header;
+    memcpy(&header, _mapped, sizeof(header));
+    if (memcmp(header.magic, kMagic, 4) != 0 || header.version != kFileVersion || header.maxPieces > kMaxSupportedPieces ||
+        sizeof(FileHeader) + (uint64_t)header.sliceCount * sizeof(FileSlice) > _mappedSize) {
+        std::cout << "Checkers tablebase " << path << " is not a valid table file" << std::endl;
+        close();
+        return false;
+    }
+
+    for (uint32_t i = 0; i < header.sliceCount; i++) {
+        FileSlice record;
+        memcpy(&record, _mapped + sizeof(FileHeader) + i * sizeof(FileSlice), sizeof(record));
+        Slice slice;
+        slice.key = {record.redMen, record.redKings, record.yellowMen, record.yellowKings};
+        slice.positions = record.positions;
+        slice.data = _mapped + record.offset;
+        if (record.offset + (record.positions + 3) / 4 > _mappedSize || slice.positions != sliceSize(slice.key)) {
+            std::cout << "Checkers tablebase " << path << " is truncated" << std::endl;
+            close();
+            return false;
+        }
+        _slices.push_back(slice);
+    }
+    _maxPieces = (int)header.maxPieces;
+    buildLookup();
+    return true;
+}
+
+void CheckersTablebase::close()
+{
+#ifdef _WIN32
+    if (_mapped) UnmapViewOfFile(_mapped);
+    if (_mappingHandle) CloseHandle((HANDLE)_mappingHandle);
+    if (_fileHandle) CloseHandle((HANDLE)_fileHandle);
+#else
+    if (_mapped) munmap((void *)_mapped, _mappedSize);
+#endif
+    _mapped = nullptr;
+    _mappedSize = 0;
+    _fileHandle = nullptr;
+    _mappingHandle = nullptr;
+    _slices.clear();
+    _lookup.clear();
+    _maxPieces = 0;
+}
+
+// ---- generation ----
+
+//
+// retrograde solver. slices are solved smallest first: captures always lead to fewer pieces
+// and promotions to fewer men, so every move that leaves the slice lands in a table that is
+// already finished. a slice is solved together with its colour-swapped partner, since a quiet
+// move from one always lands in the other once the board is turned around for the opponent.
+//
+class CheckersTablebase::Builder
+{
+public:
+    explicit Builder(int maxPieces) : _maxPieces(maxPieces)
+    {
+        _solved._maxPieces = maxPieces;
+    }
+
+    bool run(const std::string &path)
+    {
+        std::vector<SliceKey> keys = orderedSlices();
+        std::vector<bool> done(keys.size(), false);
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (done[i]) continue;
+            SliceKey partner = {keys[i].yellowMen, keys[i].yellowKings, keys[i].redMen, keys[i].redKings};
+            std::vector<SliceKey> group = {keys[i]};
+            for (size_t j = i + 1; j < keys.size(); j++) {
+                if (!done[j] && sameKey(keys[j], partner)) {
+                    group.push_back(keys[j]);
+                    done[j] = true;
+                }
+            }
+            done[i] = true;
+            solveGroup(group);
+        }
+        return write(path);
+    }
+
+private:
+    enum State : uint8_t
+    {
+        kOpen = 0,
+        kStateWin,
+        kStateLoss,
+        kStateInvalid,
+        kStateDraw
+    };
+
+    static const uint8_t kHasDrawExit = 0x80;
+
+    static bool sameKey(const SliceKey &a, const SliceKey &b)
+    {
+        return a.redMen == b.redMen && a.redKings == b.redKings && a.yellowMen == b.yellowMen && a.yellowKings == b.yellowKings;
+    }
+
+    std::vector<SliceKey> orderedSlices() const
+    {
+        std::vector<SliceKey> keys;
+        for (int rm = 0; rm <= _maxPieces; rm++)
+            for (int rk = 0; rm + rk <= _maxPieces; rk++)
+                for (int ym = 0; rm + rk + ym <= _maxPieces; ym++)
+                    for (int yk = 0; rm + rk + ym + yk <= _maxPieces; yk++) {
+                        if (rm + rk == 0 || ym + yk == 0) continue;
+                        if (rm > 12 || ym > 12) continue;
+                        keys.push_back({(uint8_t)rm, (uint8_t)rk, (uint8_t)ym, (uint8_t)yk});
+                    }
+        std::stable_sort(keys.begin(), keys.end(), [](const SliceKey &a, const SliceKey &b) {
+            int pa = a.redMen + a.redKings + a.yellowMen + a.yellowKings;
+            int pb = b.redMen + b.redKings + b.yellowMen + b.yellowKings;
+            if (pa != pb) return pa < pb;
+            return a.redMen + a.yellowMen < b.redMen + b.yellowMen;
+        });
+        return keys;
+    }
+
+    void solveGroup(const std::vector<SliceKey> &group)
+    {
+        std::vector<uint64_t> base(group.size() + 1, 0);
+        for (size_t g = 0; g < group.size(); g++) {
+            base[g + 1] = base[g] + sliceSize(group[g]);
+        }
+        uint64_t total = base.back();
+        std::vector<uint8_t> state(total, kOpen);
+        std::vector<uint8_t> counter(total, 0);
+        std::deque<uint64_t> queue;
+
+        auto groupIndex = [&](const CheckersBoard &board, uint64_t &out) {
+            SliceKey key = keyFor(board);
+            for (size_t g = 0; g < group.size(); g++) {
+                if (sameKey(key, group[g])) {
+                    out = base[g] + indexOf(board, key);
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        // first pass: terminal positions and moves that leave the group
+        CheckersMoveList moves;
+        for (size_t g = 0; g < group.size(); g++) {
+            for (uint64_t index = 0; index < base[g + 1] - base[g]; index++) {
+                uint64_t position = base[g] + index;
+                CheckersBoard board;
+                if (!boardAt(group[g], index, board)) {
+                    state[position] = kStateInvalid;
+                    continue;
+                }
+                board.generateMoves(moves);
+                if (moves.empty()) {
+                    state[position] = kStateLoss;
+                    queue.push_back(position);
+                    continue;
+                }
+                int inside = 0;
+                bool win = false;
+                bool drawExit = false;
+                for (const CheckersMove &move : moves) {
+                    CheckersBoard child = board;
+                    child.makeMove(move);
+                    CheckersBoard next = canonical(child);
+                    uint64_t childIndex;
+                    if (next.red && groupIndex(next, childIndex)) {
+                        inside++;
+                        continue;
+                    }
+                    Value value = _solved.probe(next);
+                    if (value == kLoss) {
+                        win = true;
+                        break;
+                    }
+                    if (value != kWin) {
+                        drawExit = true;
+                    }
+                }
+                if (win) {
+                    state[position] = kStateWin;
+                    queue.push_back(position);
+                } else if (inside == 0) {
+                    state[position] = drawExit ? kStateDraw : kStateLoss;
+                    if (!drawExit) queue.push_back(position);
+                } else {
+                    counter[position] = (uint8_t)inside | (drawExit ? kHasDrawExit : 0);
+                }
+            }
+        }
+
+        // second pass: walk quiet moves backwards from every decided position
+        while (!queue.empty()) {
+            uint64_t position = queue.front();
+            queue.pop_front();
+            size_t g = std::upper_bound(base.begin(), base.end(), position) - base.begin() - 1;
+            CheckersBoard decided;
+            boardAt(group[g], position - base[g], decided);
+            bool childLost = state[position] == kStateLoss;
+
+            // turn the board back so red is the side that just moved
+            CheckersBoard after = flipped(decided);
+            uint32_t empty = ~after.occupied();
+            for (uint32_t pieces = after.red; pieces; pieces &= pieces - 1) {
+                int square = std::countr_zero(pieces);
+                bool king = (after.kings >> square) & 1;
+                for (int dir = 0; dir < 4; dir++) {
+                    // men only ever step towards y = 7, so they came from the row above
+                    if (!king && dir != CheckersBoard::kFrontLeft && dir != CheckersBoard::kFrontRight) continue;
+                    int from = CheckersBoard::neighbor(square, dir);
+                    if (from < 0 || !(empty & (1u << from))) continue;
+
+                    CheckersBoard before = after;
+                    before.red = (before.red & ~(1u << square)) | (1u << from);
+                    if (king) {
+                        before.kings = (before.kings & ~(1u << square)) | (1u << from);
+                    }
+                    before.redToMove = true;
+                    // a quiet move is only legal when no capture was available
+                    if (before.hasCapture()) continue;
+
+                    uint64_t parent;
+                    if (!groupIndex(before, parent) || state[parent] != kOpen) continue;
+                    if (childLost) {
+                        state[parent] = kStateWin;
+                        queue.push_back(parent);
+                    } else if (((--counter[parent]) & ~kHasDrawExit) == 0) {
+                        if (counter[parent] & kHasDrawExit) {
+                            state[parent] = kStateDraw;
+                        } else {
+                            state[parent] = kStateLoss;
+                            queue.push_back(parent);
+                        }
+                    }
+                }
+            }
+        }
+
+        // pack and publish so later slices can probe into these
+        for (size_t g = 0; g < group.size(); g++) {
+            uint64_t size = base[g + 1] - base[g];
+            std::vector<uint8_t> packed((size + 3) / 4, 0);
+            uint64_t wins = 0, losses = 0, draws = 0;
+            for (uint64_t index = 0; index < size; index++) {
+                Value value = kDraw;
+                switch (state[base[g] + index]) {
+                case kStateWin: value = kWin; wins++; break;
+                case kStateLoss: value = kLoss; losses++; break;
+                case kStateInvalid: value = kInvalid; break;
+                default: draws++; break;
+                }
+                packed[index >> 2] |= (uint8_t)(value << ((index & 3) * 2));
+            }
+            _data.push_back(std::move(packed));
+            Slice slice;
+            slice.key = group[g];
+            slice.positions = size;
+            slice.data = _data.back().data();
+            _solved._slices.push_back(slice);
+            _solved.buildLookup();
+            std::cout << "slice " << (int)group[g].redMen << (int)group[g].redKings << (int)group[g].yellowMen << (int)group[g].yellowKings
+                      << ": " << size << " positions, " << wins << " wins, " << losses << " losses, " << draws << " draws" << std::endl;
+        }
+    }
+
+    bool write(const std::string &path) const
+    {
+        std::ofstream out(path, std::ios::binary);
+        if (!out) {
+            std::cout << "Could not write " << path << std::endl;
+            return false;
+        }
+        FileHeader header;
+        memcpy(header.magic, kMagic, 4);
+        header.version = kFileVersion;
+        header.maxPieces = (uint32_t)_maxPieces;
+        header.sliceCount = (uint32_t)_solved._slices.size();
+        out.write((const char *)&header, sizeof(header));
+
+        uint64_t offset = sizeof(FileHeader) + _solved._slices.size() * sizeof(FileSlice);
+        for (size_t i = 0; i < _solved._slices.size(); i++) {
+            const Slice &slice = _solved._slices[i];
+            FileSlice record = {};
+            record.redMen = slice.key.redMen;
+            record.redKings = slice.key.redKings;
+            record.yellowMen = slice.key.yellowMen;
+            record.yellowKings = slice.key.yellowKings;
+            record.offset = offset;
+            record.positions = slice.positions;
+            out.write((const char *)&record, sizeof(record));
+            offset += _data[i].size();
+        }
+        for (const auto &data : _data) {
+            out.write((const char *)data.data(), (std::streamsize)data.size());
+        }
+        return (bool)out;
+    }
+
+    int _maxPieces;
+    std::vector<std::vector<uint8_t>> _data;
+    CheckersTablebase _solved;
+};
+
+bool CheckersTablebase::generate(int maxPieces, const std::string &path)
+{
+    if (maxPieces < 2 || maxPieces > kMaxSupportedPieces) {
+        std::cout << "Tablebase piece count must be between 2 and " << kMaxSupportedPieces << std::endl;
+        return false;
+    }
+    Builder builder(maxPieces);
+    return builder.run(path);
+}
+
+// ---- verification ----
+
+namespace {
+
+//
+// plain depth limited proof search, no tables involved.
+// returns 1 for a proven win, -1 for a proven loss and 0 when the depth ran out.
+//
+int proveBruteForce(const CheckersBoard &board, int depth, std::unordered_map<uint64_t, int8_t> &memo)
+{
+    if (!(board.redToMove ? board.red : board.yellow)) {
+        return -1;
+    }
+    if (depth == 0) {
+        return 0;
+    }
+    uint64_t key = (uint64_t)board.red * 0x9E3779B97F4A7C15ull ^ (uint64_t)board.yellow * 0xC2B2AE3D27D4EB4Full ^
+                   (uint64_t)board.kings * 0x165667B19E3779F9ull ^ ((uint64_t)depth << 1) ^ (board.redToMove ? 1 : 0);
+    auto it = memo.find(key);
+    if (it != memo.end()) {
+        return it->second;
+    }
+    CheckersMoveList moves;
+    board.generateMoves(moves);
+    int best = -1;
+    for (const CheckersMove &move : moves) {
+        CheckersBoard child = board;
+        child.makeMove(move);
+        int value = -proveBruteForce(child, depth - 1, memo);
+        best = std::max(best, value);
+        if (best == 1) break;
+    }
+    memo[key] = (int8_t)best;
+    return best;
+}
+
+} // namespace
+
+int CheckersTablebase::verify(int samples, int searchDepth, unsigned int seed) const
+{
+    if (!isOpen()) {
+        return 0;
+    }
+    std::mt19937_64 rng(seed);
+    int checked = 0, childMismatches = 0, searchMismatches = 0, proven = 0;
+    std::unordered_map<uint64_t, int8_t> memo;
+
+    while (checked < samples) {
+        const Slice &slice = _slices[rng() % _slices.size()];
+        uint64_t index = rng() % slice.positions;
+        CheckersBoard board;
+        if (!boardAt(slice.key, index, board)) {
+            continue;
+        }
+        checked++;
+        Value stored = readValue(slice.data, index);
+
+        // one ply consistency: the entry has to follow from its children
+        CheckersMoveList moves;
+        board.generateMoves(moves);
+        bool anyChildLost = false, allChildrenWon = true;
+        for (const CheckersMove &move : moves) {
+            CheckersBoard child = board;
+            child.makeMove(move);
+            Value value = probe(child);
+            anyChildLost = anyChildLost || value == kLoss;
+            allChildrenWon = allChildrenWon && value == kWin;
+        }
+        Value expected = anyChildLost ? kWin : (allChildrenWon ? kLoss : kDraw);
+        if (expected != stored) {
+            childMismatches++;
+        }
+
+        // a brute force proof, where one is found in time, has to agree
+        memo.clear();
+        int result = proveBruteForce(board, searchDepth, memo);
+        if (result != 0) {
+            proven++;
+            if ((result > 0 && stored != kWin) || (result < 0 && stored != kLoss)) {
+                searchMismatches++;
+            }
+        }
+    }
+
+    std::cout << "verified " << checked << " positions: " << childMismatches << " child mismatches, " << proven
+              << " proven by search with " << searchMismatches << " disagreements" << std::endl;
+    return childMismatches + searchMismatches;
+}
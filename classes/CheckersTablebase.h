@@ -0,0 +1,96 @@
+#pragma once
+
+#include "CheckersBoard.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//
+// win/loss/draw endgame tables for checkers positions with few pieces
+// tables are built offline by retrograde analysis (see tools/checkers_tbgen.cpp) and written
+// to one file, which the game memory-maps and probes from the AI search.
+//
+// positions are stored from red's point of view only: a yellow-to-move position is rotated
+// 180 degrees with the colours swapped before lookup. each slice of the table holds one
+// combination of red men, red kings, yellow men and yellow kings, and each position is packed
+// into two bits.
+//
+
+class CheckersTablebase
+{
+public:
+    enum Value : uint8_t
+    {
+        kDraw = 0,
+        kWin = 1,
+        kLoss = 2,
+        kInvalid = 3,
+        kUnknown = 4        // not covered by the loaded tables
+    };
+
+    static const int kMaxSupportedPieces = 8;
+
+    CheckersTablebase() = default;
+    ~CheckersTablebase();
+    CheckersTablebase(const CheckersTablebase &) = delete;
+    CheckersTablebase &operator=(const CheckersTablebase &) = delete;
+
+    // tables shared by every game, loaded on first use from resources/
+    static CheckersTablebase &shared();
+    static const char *defaultPath() { return "resources/checkers_endgame.cktb"; }
+
+    bool        open(const std::string &path);
+    void        close();
+    bool        isOpen() const { return !_slices.empty(); }
+    int         maxPieces() const { return _maxPieces; }
+
+    // result for the side to move, kUnknown when the position has too many pieces
+    Value       probe(const CheckersBoard &board) const;
+
+    // build every table with up to maxPieces pieces and write them to path
+    static bool generate(int maxPieces, const std::string &path);
+
+    // cross-check random table entries against their children and a brute force search.
+    // returns the number of entries that disagree.
+    int         verify(int samples, int searchDepth, unsigned int seed) const;
+
+    // mirror the board so that red is to move
+    static CheckersBoard canonical(const CheckersBoard &board);
+
+private:
+    struct SliceKey
+    {
+        uint8_t redMen = 0;
+        uint8_t redKings = 0;
+        uint8_t yellowMen = 0;
+        uint8_t yellowKings = 0;
+    };
+
+    struct Slice
+    {
+        SliceKey        key;
+        uint64_t        positions = 0;
+        const uint8_t   *data = nullptr;
+    };
+
+    class Builder;
+
+    static SliceKey keyFor(const CheckersBoard &redToMove);
+    static uint64_t sliceSize(const SliceKey &key);
+    static uint64_t indexOf(const CheckersBoard &redToMove, const SliceKey &key);
+    static bool     boardAt(const SliceKey &key, uint64_t index, CheckersBoard &board);
+    static Value    readValue(const uint8_t *data, uint64_t index) { return (Value)((data[index >> 2] >> ((index & 3) * 2)) & 3); }
+
+    const Slice *findSlice(const SliceKey &key) const;
+    void        buildLookup();
+
+    std::vector<Slice>  _slices;
+    std::vector<int>    _lookup;        // slice number by piece counts, -1 when absent
+    int                 _maxPieces = 0;
+
+    // memory mapping
+    const uint8_t   *_mapped = nullptr;
+    size_t          _mappedSize = 0;
+    void            *_fileHandle = nullptr;
+    void            *_mappingHandle = nullptr;
+};
@@ -1,10 +1,13 @@
 #include "Connect4.h"
 #include "imgui/imgui.h"
+#include "TextureCache.h"
+#include "Profiler.h"
+#include "Connect4Analysis.h"
 #include <cstring>
 #include <sstream>
 
 Connect4::Connect4() { resetBoard(); }
-Connect4::~Connect4() { stopGame(); }
+Connect4::~Connect4() { stopGame(); releaseTextures(); }
 
 // ---- Game (pure virtual) ----
 void Connect4::setUpBoard() {
@@ -15,6 +18,7 @@ void Connect4::setUpBoard() {
 }
 
 void Connect4::drawFrame() {
+    PROFILE_SCOPE("Connect4::drawFrame");
     // Two columns: left = board, right = status (matches the app's UI pattern)
     ImGui::Columns(2, nullptr, true);
     drawLeftPanel();
@@ -52,6 +56,7 @@ void Connect4::stopGame()
 // ---- Per-frame update ----
 void Connect4::update(float dt)
 {
+    PROFILE_SCOPE("Connect4::update");
     if (!running) return;
 
     // Step piece drop animation if active
@@ -60,7 +65,7 @@ void Connect4::update(float dt)
         return; // while animating, we don't accept new input / AI
     }
 
-    if (gameOver) return;
+    if (gameOver || isReviewingHistory()) return;
 
     // AI turn?
     if (vsAI && currentPlayer == aiSide) {
@@ -95,19 +100,30 @@ void Connect4::drawLeftPanel()
 
     ImGui::SliderFloat("Cell size", &cell, 40.f, 90.f, "%.0f px");
     ImGui::Checkbox("Animate drop", &animateDrops);
+    ImGui::SameLine();
+    ImGui::Checkbox("Analysis", &showAnalysis);
+    updateAnalysis();
 
     // Board canvas
     ImDrawList* drawList = ImGui::GetWindowDrawList();
+    ImVec2 analysisRow(0,0);
+    if (showAnalysis) {
+        ImGui::Dummy(ImVec2(cell*COLS + 16, ImGui::GetTextLineHeight()));
+        analysisRow = ImVec2(ImGui::GetItemRectMin().x + 8, ImGui::GetItemRectMin().y);
+    }
     ImGui::Dummy(ImVec2(cell*COLS + 16, cell*ROWS + 16)); // reserve space
     ImVec2 p = ImGui::GetItemRectMin();
     boardTopLeft = ImVec2(p.x + 8, p.y + 8);
 
+    int firstVertex = drawList->VtxBuffer.Size;
     drawGridBackground(drawList, boardTopLeft, cell);
     drawBoard();
     drawHoverIndicator(drawList);
+    boardVertices = drawList->VtxBuffer.Size - firstVertex;
+    if (showAnalysis) drawAnalysis(drawList, analysisRow);
 
     // Column click handling
-    if (!gameOver && (!vsAI || currentPlayer != aiSide) && !anim.active) {
+    if (!gameOver && (!vsAI || currentPlayer != aiSide) && !anim.active && !isReviewingHistory()) {
         ImVec2 mouse = ImGui::GetMousePos();
         hoverColumn = -1;
         // detect hover
@@ -178,6 +194,13 @@ void Connect4::drawRightPanel()
         ImGui::RadioButton("AI is Yellow (Player 2)", &tmp, 2);
         if (tmp != aiSide) { aiSide = tmp; startGame(vsAI, aiSide); }
     }
+
+    ImGui::Separator();
+    ImGui::Text("Board vertices: %d", boardVertices);
+    if (vsAI) {
+        ImGui::Separator();
+        aiStats.draw();
+    }
 }
 
 // ===== helpers =====
@@ -208,6 +231,9 @@ bool Connect4::applyMove(int col, int player, int& outRow)
             board[col][r] = player;
             outRow = r;
             movesMade++;
+            recordMove(uint32_t(col) | (uint32_t(player) << 3));
+            // keep Game's turn count in step with the history so stepping back can count it down
+            _gameOptions.currentTurnNo++;
             return true;
         }
     }
@@ -252,34 +278,155 @@ bool Connect4::checkAnyWin(int& outWinner) const
     return false;
 }
 
-void Connect4::drawGridBackground(ImDrawList* dl, const ImVec2& p, float size)
+// ---- Cached board / disc textures ----
+namespace {
+    // anti-aliased coverage of a pixel from the signed distance to an edge (negative inside)
+    float coverage(float distance) { return std::clamp(0.5f - distance, 0.0f, 1.0f); }
+
+    float roundedRectDistance(float x, float y, float w, float h, float rounding)
+    {
+        float qx = std::fabs(x - w*0.5f) - (w*0.5f - rounding);
+        float qy = std::fabs(y - h*0.5f) - (h*0.5f - rounding);
+        float outside = std::sqrt(std::max(qx, 0.0f)*std::max(qx, 0.0f) + std::max(qy, 0.0f)*std::max(qy, 0.0f));
+        return outside + std::min(std::max(qx, qy), 0.0f) - rounding;
+    }
+
+    // src over dst, both straight alpha
+    void blendOver(unsigned char* px, float r, float g, float b, float a)
+    {
+        float da = px[3] / 255.0f;
+        float oa = a + da * (1.0f - a);
+        if (oa <= 0.0f) return;
+        px[0] = (unsigned char)((r*a + px[0]/255.0f*da*(1.0f - a)) / oa * 255.0f + 0.5f);
+        px[1] = (unsigned char)((g*a + px[1]/255.0f*da*(1.0f - a)) / oa * 255.0f + 0.5f);
+        px[2] = (unsigned char)((b*a + px[2]/255.0f*da*(1.0f - a)) / oa * 255.0f + 0.5f);
+        px[3] = (unsigned char)(oa * 255.0f + 0.5f);
+    }
+}
+
+void Connect4::ensureTextures()
 {
-    const ImU32 bg = IM_COL32(25, 71, 140, 255); // board blue
-    dl->AddRectFilled(p, ImVec2(p.x + size*COLS, p.y + size*ROWS), bg, 12.0f);
+    if (boardTexture && diskTexture && texturesCell == cell) return;
+    releaseTextures();
+    texturesCell = cell;
+    const float radius = cell*0.38f;
 
-    // holes: draw white circles then overlay later with disks
-    for (int c=0;c<COLS;++c) for (int r=0;r<ROWS;++r) {
-        ImVec2 center(p.x + (c+0.5f)*size, p.y + (ROWS-1-r + 0.5f)*size);
-        dl->AddCircleFilled(center, size*0.38f, IM_COL32(240,240,240,255), 32);
+    // board: blue rounded rect with the white holes punched in
+    int bw = (int)std::ceil(cell*COLS), bh = (int)std::ceil(cell*ROWS);
+    std::vector<unsigned char> pixels((size_t)bw*bh*4, 0);
+    for (int y=0;y<bh;++y) for (int x=0;x<bw;++x) {
+        unsigned char* px = &pixels[((size_t)y*bw + x)*4];
+        float fx = x + 0.5f, fy = y + 0.5f;
+        blendOver(px, 25/255.0f, 71/255.0f, 140/255.0f, coverage(roundedRectDistance(fx, fy, cell*COLS, cell*ROWS, 12.0f)));
+        float hx = std::fmod(fx, cell) - cell*0.5f, hy = std::fmod(fy, cell) - cell*0.5f;
+        if (fx < cell*COLS && fy < cell*ROWS)
+            blendOver(px, 240/255.0f, 240/255.0f, 240/255.0f, coverage(std::sqrt(hx*hx + hy*hy) - radius));
+    }
+    boardTexture = TextureCache::instance().createTexture(pixels.data(), bw, bh);
+    boardTextureSize = ImVec2((float)bw, (float)bh);
+
+    // disc: white so it can be tinted per player, with the dark 2px outline on top
+    int ds = (int)std::ceil(radius*2.0f + 4.0f);
+    pixels.assign((size_t)ds*ds*4, 0);
+    for (int y=0;y<ds;++y) for (int x=0;x<ds;++x) {
+        unsigned char* px = &pixels[((size_t)y*ds + x)*4];
+        float dx = x + 0.5f - ds*0.5f, dy = y + 0.5f - ds*0.5f;
+        float d = std::sqrt(dx*dx + dy*dy);
+        blendOver(px, 1.0f, 1.0f, 1.0f, coverage(d - radius));
+        blendOver(px, 0.0f, 0.0f, 0.0f, coverage(std::fabs(d - radius) - 1.0f) * (80/255.0f));
     }
+    diskTexture = TextureCache::instance().createTexture(pixels.data(), ds, ds);
+    diskTextureSize = ImVec2((float)ds, (float)ds);
+}
+
+void Connect4::releaseTextures()
+{
+    TextureCache::instance().destroyTexture(boardTexture);
+    TextureCache::instance().destroyTexture(diskTexture);
+    boardTexture = 0;
+    diskTexture = 0;
+    texturesCell = 0.0f;
+}
+
+void Connect4::drawGridBackground(ImDrawList* dl, const ImVec2& p, float size)
+{
+    ensureTextures();
+    dl->AddImage(boardTexture, p, ImVec2(p.x + boardTextureSize.x, p.y + boardTextureSize.y));
 }
 
 void Connect4::drawDisk(ImDrawList* dl, const ImVec2& center, float radius, int color)
 {
     ImU32 fill = (color==1) ? IM_COL32(220,60,60,255) : IM_COL32(240,220,60,255);
-    ImU32 border = IM_COL32(0,0,0,80);
-    dl->AddCircleFilled(center, radius, fill, 48);
-    dl->AddCircle(center, radius, border, 48, 2.0f);
+    ensureTextures();
+    ImVec2 half(diskTextureSize.x*0.5f, diskTextureSize.y*0.5f);
+    dl->AddImage(diskTexture, ImVec2(center.x - half.x, center.y - half.y), ImVec2(center.x + half.x, center.y + half.y),
+                 ImVec2(0,0), ImVec2(1,1), fill);
 }
 
 void Connect4::drawHoverIndicator(ImDrawList* dl)
 {
-    if (hoverColumn < 0 || gameOver || (vsAI && currentPlayer==aiSide) || anim.active) return;
+    if (hoverColumn < 0 || gameOver || (vsAI && currentPlayer==aiSide) || anim.active || isReviewingHistory()) return;
     if (!canPlay(hoverColumn)) return;
     ImVec2 center(boardTopLeft.x + (hoverColumn+0.5f)*cell, boardTopLeft.y - cell*0.5f);
     drawDisk(dl, center, cell*0.38f, currentPlayer);
 }
 
+bool Connect4::isAnimating()
+{
+    return anim.active || (analysis && analysis->running());
+}
+
+// ---- Analysis ----
+// the worker restarts whenever the position on the board changes, including while stepping
+// through the history, and stops when the analysis is switched off or the game is decided
+void Connect4::updateAnalysis()
+{
+    bool wanted = showAnalysis && running && !gameOver;
+    if (!wanted) {
+        if (analysis) analysis->stop();
+        analysisPlayer = 0;
+        return;
+    }
+    if (!analysis) analysis = std::make_unique<Connect4Analysis>();
+    if (analysisPlayer != currentPlayer || analysis->board() != board) {
+        analysis->start(board, currentPlayer);
+        analysisPlayer = currentPlayer;
+    }
+}
+
+void Connect4::drawAnalysis(ImDrawList* dl, const ImVec2& rowTopLeft)
+{
+    if (!analysis || !analysisPlayer) return;
+    Connect4Analysis::Snapshot snap = analysis->latest();
+
+    int bestCol = -1;
+    for (int c=0;c<COLS;++c) {
+        const auto& column = snap.columns[c];
+        if (column.depth && (bestCol < 0 || column.score > snap.columns[bestCol].score)) bestCol = c;
+    }
+    for (int c=0;c<COLS;++c) {
+        const auto& column = snap.columns[c];
+        if (!column.legal) continue;
+        char text[16];
+        ImU32 color = IM_COL32(220,220,220,255);
+        if (!column.depth) {
+            snprintf(text, sizeof(text), "...");
+            color = IM_COL32(140,140,140,255);
+        } else if (Connect4Analysis::isWin(column.score)) {
+            // forced results count whole moves of the side to move
+            int moves = (Connect4Analysis::pliesToWin(column.score) + 1) / 2;
+            snprintf(text, sizeof(text), column.score > 0 ? "W%d" : "L%d", moves);
+            color = column.score > 0 ? IM_COL32(90,220,90,255) : IM_COL32(230,80,80,255);
+        } else {
+            snprintf(text, sizeof(text), "%+d", column.score);
+        }
+        if (c == bestCol && !(Connect4Analysis::isWin(column.score) && column.score < 0)) color = IM_COL32(90,220,90,255);
+        ImVec2 size = ImGui::CalcTextSize(text);
+        dl->AddText(ImVec2(rowTopLeft.x + (c+0.5f)*cell - size.x*0.5f, rowTopLeft.y), color, text);
+    }
+    ImGui::Text("Analysis depth %d%s", snap.depth, snap.finished ? "" : "...");
+}
+
 void Connect4::launchDropAnim(int col, int row, int color)
 {
     anim.active = true;
@@ -326,6 +473,8 @@ void Connect4::drawBoard()
 void Connect4::nextTurn()
 {
     currentPlayer = (currentPlayer == 1) ? 2 : 1;
+    // the state string carries the player to move, so keyframes wait until it has changed hands
+    commitTurn();
 }
 
 void Connect4::concludeIfTerminal()
@@ -348,32 +497,11 @@ static inline int randFallback() { return 3; } // deterministic fallback center
 
 int Connect4::aiChooseMove()
 {
-    const int maxDepth = 6;
+    PROFILE_SCOPE("Connect4::aiChooseMove");
+    if (legalMoves().empty()) return -1;
 
-    Board b = board;
-    int me = aiSide;
-    int bestCol = -1;
-    int bestScore = std::numeric_limits<int>::min();
-
-    auto moves = legalMoves();
-    if (moves.empty()) return -1;
-
-    // Prefer center in ties
-    std::sort(moves.begin(), moves.end(), [](int a, int b){
-        int ca = std::abs(3 - a), cb = std::abs(3 - b);
-        return ca < cb;
-    });
-
-    int alpha = std::numeric_limits<int>::min();
-    int beta  = std::numeric_limits<int>::max();
-    for (int col : moves) {
-        Board nb = b;
-        if (!simApply(nb, col, me)) continue;
-        int score = minimax(nb, maxDepth-1, alpha, beta, false, me);
-        if (score > bestScore) { bestScore = score; bestCol = col; }
-        alpha = std::max(alpha, score);
-        if (beta <= alpha) break;
-    }
+    int bestCol = ai.search(board, aiSide, AI_DEPTH).column;
+    aiStats = ai.stats();
 
     if (bestCol < 0) {
         for (int c : {3,2,4,1,5,0,6}) if (canPlay(c)) return c;
@@ -382,156 +510,6 @@ int Connect4::aiChooseMove()
     return bestCol;
 }
 
-int Connect4::minimax(Board b, int depth, int alpha, int beta, bool maximizing, int me)
-{
-    int w=0;
-    for (int c=0;c<COLS;++c) for (int r=0;r<ROWS;++r) {
-        int p = b[c][r]; if (!p) continue;
-        if (simWinAt(b,c,r,p)) { w = p; goto doneScan; }
-    }
-doneScan:
-    if (w)   return (w == me) ? 100000 : -100000;
-
-    bool hasMove = false;
-    for (int c=0;c<COLS;++c) if (simCanPlay(b,c)) { hasMove = true; break; }
-    if (!hasMove) return 0;
-    if (depth == 0) return evaluateBoard(b, me);
-
-    if (maximizing) {
-        int best = std::numeric_limits<int>::min();
-        auto moves = simMoves(b);
-        std::sort(moves.begin(), moves.end(), [](int a, int b){
-            int ca = std::abs(3-a), cb = std::abs(3-b);
-            return ca < cb;
-        });
-        for (int col : moves) {
-            Board nb = b;
-            simApply(nb, col, me);
-            int val = minimax(nb, depth-1, alpha, beta, false, me);
-            best = std::max(best, val);
-            alpha = std::max(alpha, val);
-            if (beta <= alpha) break;
-        }
-        return best;
-    } else {
-        int opp = (me==1)?2:1;
-        int best = std::numeric_limits<int>::max();
-        auto moves = simMoves(b);
-        std::sort(moves.begin(), moves.end(), [](int a, int b){
-            int ca = std::abs(3-a), cb = std::abs(3-b);
-            return ca < cb;
-        });
-        for (int col : moves) {
-            Board nb = b;
-            simApply(nb, col, opp);
-            int val = minimax(nb, depth-1, alpha, beta, true, me);
-            best = std::min(best, val);
-            beta = std::min(beta, val);
-            if (beta <= alpha) break;
-        }
-        return best;
-    }
-}
-
-int Connect4::evaluateBoard(const Board& b, int me) const
-{
-    int opp = (me==1)?2:1;
-    auto scoreFor = [&](int who)->int{
-        int s = 0;
-
-        // center preference
-        int centerCount = 0;
-        for (int r=0;r<ROWS;++r) if (b[3][r]==who) centerCount++;
-        s += centerCount * 6;
-
-        auto scoreLine = [&](int c0,int r0,int dc,int dr){
-            std::array<int,4> w{};
-            int sLocal=0;
-            for (;;) {
-                int c=c0, r=r0;
-                for (int i=0;i<4;++i) {
-                    if (c<0||c>=COLS||r<0||r>=ROWS) return sLocal;
-                    w[i] = b[c][r]; c+=dc; r+=dr;
-                }
-                sLocal += scoreWindow(w, who);
-                c0+=dc; r0+=dr;
-            }
-        };
-
-        // Horizontal rows
-        for (int r=0;r<ROWS;++r) s += scoreLine(0,r,1,0);
-        // Vertical cols
-        for (int c=0;c<COLS;++c) s += scoreLine(c,0,0,1);
-        // Diagonals /
-        for (int c=0;c<=COLS-4;++c) s += scoreLine(c,ROWS-4,1,1);
-        for (int r=ROWS-4;r>=0;--r) s += scoreLine(0,r,1,1);
-        // Diagonals \
-        for (int c=0;c<=COLS-4;++c) s += scoreLine(c,3,1,-1);
-        for (int r=3;r<ROWS;++r)     s += scoreLine(0,r,1,-1);
-
-        return s;
-    };
-
-    int myS  = scoreFor(me);
-    int opS  = scoreFor(opp);
-    return myS - opS;
-}
-
-int Connect4::scoreWindow(const std::array<int,4>& w, int me) const
-{
-    int opp = (me==1)?2:1;
-    int meCnt=0, oppCnt=0, empty=0;
-    for (int v : w) { if (v==me) meCnt++; else if (v==opp) oppCnt++; else empty++; }
-
-    if (meCnt==4) return 10000;
-    if (meCnt==3 && empty==1) return 100;
-    if (meCnt==2 && empty==2) return 12;
-
-    if (oppCnt==3 && empty==1) return -120; // block threats more urgently
-    if (oppCnt==4) return -10000;
-
-    return 0;
-}
-
-// === static board helpers for AI ===
-bool Connect4::simCanPlay(const Board& b, int col)
-{
-    if (col<0 || col>=COLS) return false;
-    return b[col][ROWS-1]==0;
-}
-
-bool Connect4::simApply(Board& b, int col, int player)
-{
-    if (!simCanPlay(b,col)) return false;
-    for (int r=0;r<ROWS;++r) if (b[col][r]==0) { b[col][r]=player; return true; }
-    return false;
-}
-
-std::vector<int> Connect4::simMoves(const Board& b)
-{
-    std::vector<int> m;
-    for (int c=0;c<COLS;++c) if (simCanPlay(b,c)) m.push_back(c);
-    return m;
-}
-
-int Connect4::simCountDir(const Board& b, int c, int r, int dc, int dr, int player)
-{
-    int cnt=0;
-    while (c>=0&&c<COLS&&r>=0&&r<ROWS&&b[c][r]==player){cnt++; c+=dc; r+=dr;}
-    return cnt;
-}
-
-bool Connect4::simWinAt(const Board& b, int col, int row, int player)
-{
-    auto line = [&](int dc,int dr){
-        int total=1;
-        int cc=col-dc, rr=row-dr; while (cc>=0&&cc<COLS&&rr>=0&&rr<ROWS&&b[cc][rr]==player){total++; cc-=dc; rr-=dr;}
-        cc=col+dc; rr=row+dr;     while (cc>=0&&cc<COLS&&rr>=0&&rr<ROWS&&b[cc][rr]==player){total++; cc+=dc; rr+=dr;}
-        return total>=4;
-    };
-    return line(1,0)||line(0,1)||line(1,1)||line(1,-1);
-}
-
 // ---- Game-required overrides (non-UI) ----
 bool Connect4::canBitMoveFrom(Bit &, BitHolder &) { return false; }
 bool Connect4::canBitMoveFromTo(Bit &, BitHolder &, BitHolder &) { return false; }
@@ -595,8 +573,75 @@ void Connect4::setStateString(const std::string &s)
     // recompute movesMade and winner
     movesMade = 0;
     for (int c=0;c<COLS;++c) for (int r=0;r<ROWS;++r) if (board[c][r]) movesMade++;
+    refreshResult();
+}
+
+void Connect4::refreshResult()
+{
     int w=0; winner=0; gameOver=false;
     if (checkAnyWin(w)) { winner=w; gameOver=true; }
+    else if (isDraw()) { gameOver=true; }
+}
+
+// history steps: drop or lift the top disk of the column, the mover's opponent is then to play
+void Connect4::applyMove(uint32_t move)
+{
+    int col = move & 7;
+    int player = (move >> 3) & 3;
+    for (int r=0;r<ROWS;++r) {
+        if (board[col][r] == 0) { board[col][r] = player; movesMade++; break; }
+    }
+    currentPlayer = (player == 1) ? 2 : 1;
+    anim = {};
+    refreshResult();
+}
+
+void Connect4::unapplyMove(uint32_t move)
+{
+    int col = move & 7;
+    for (int r=ROWS-1;r>=0;--r) {
+        if (board[col][r] != 0) { board[col][r] = 0; movesMade--; break; }
+    }
+    currentPlayer = (move >> 3) & 3;
+    anim = {};
+    refreshResult();
+}
+
+// history moves: column in the low 3 bits, the player (1 or 2) above it
+void Connect4::applyMoveToSnapshot(BoardSnapshot &snapshot, uint32_t move) const
+{
+    if (snapshot.variant != kSnapshotVariant) return;
+    int col = move & 7;
+    int player = (move >> 3) & 3;
+    for (int r=0;r<ROWS;++r) {
+        int bit = col*ROWS + r;
+        if (!snapshot.test(0, bit) && !snapshot.test(1, bit)) { snapshot.set(player-1, bit); break; }
+    }
+    snapshot.sideToMove = (player == 1) ? 1 : 0;
+}
+
+BoardSnapshot Connect4::snapshot()
+{
+    BoardSnapshot s;
+    s.variant = kSnapshotVariant;
+    s.sideToMove = uint8_t(currentPlayer - 1);
+    for (int c=0;c<COLS;++c) for (int r=0;r<ROWS;++r) if (board[c][r]) s.set(board[c][r]-1, c*ROWS + r);
+    return s;
+}
+
+bool Connect4::restoreSnapshot(const BoardSnapshot &snapshot)
+{
+    if (snapshot.variant != kSnapshotVariant) return false;
+    movesMade = 0;
+    for (int c=0;c<COLS;++c) for (int r=0;r<ROWS;++r) {
+        int bit = c*ROWS + r;
+        board[c][r] = snapshot.test(0, bit) ? 1 : (snapshot.test(1, bit) ? 2 : 0);
+        if (board[c][r]) movesMade++;
+    }
+    currentPlayer = snapshot.sideToMove + 1;
+    anim = {};
+    refreshResult();
+    return true;
 }
 
 Grid* Connect4::getGrid()
@@ -1,5 +1,6 @@
 #pragma once
 #include "Game.h"
+#include "Connect4AI.h"
 #include "imgui/imgui.h"
 #include <array>
 #include <vector>
@@ -7,6 +8,9 @@
 #include <limits>
 #include <algorithm>
 #include <cmath>
+#include <memory>
+
+class Connect4Analysis;
 
 // Connect 4 board: 7 columns x 6 rows (columns [0..6], rows [0..5])
 // We draw with ImGui primitives; no Grid/Bits are used for gameplay.
@@ -30,6 +34,12 @@ public:
     bool isDrawn()               const { return isDraw(); }
     bool isRunning()             const { return running; }
 
+    // the drop animation and the AI both run from update(), so either needs frames to keep coming,
+    // and so does the analysis while its column scores are still changing
+    bool isAnimating() override;
+    bool isWaitingOnAI() override { return running && !gameOver && vsAI && currentPlayer == aiSide && !isReviewingHistory(); }
+    bool aiSearchStats(SearchStats &stats) override { stats = aiStats; return true; }
+
     // Lifecycle
     void startGame(bool vsAI, int aiPlaysAs);
     void stopGame() override;
@@ -42,13 +52,24 @@ public:
     std::string initialStateString() override;
     std::string stateString() override;
     void setStateString(const std::string &s) override;
+    BoardSnapshot snapshot() override;
+    bool restoreSnapshot(const BoardSnapshot &snapshot) override;
+    void applyMoveToSnapshot(BoardSnapshot &snapshot, uint32_t move) const override;
     Grid* getGrid() override;
 
+protected:
+    // history stepping edits the board directly, nothing is recorded
+    void applyMove(uint32_t move) override;
+    void unapplyMove(uint32_t move) override;
+
 private:
     // Board state: 0 = empty, 1 = red, 2 = yellow
     static constexpr int COLS = 7;
     static constexpr int ROWS = 6;
-    using Board = std::array<std::array<int, ROWS>, COLS>;
+    static constexpr int AI_DEPTH = 6;
+    using Board = Connect4Position::Board;
+    // snapshots: plane 0 red, plane 1 yellow, bit col*ROWS + row
+    static constexpr uint32_t kSnapshotVariant = BoardSnapshot::makeVariant('4', COLS, ROWS, 4);
 
     Board board{};
     bool  running = false;
@@ -58,12 +79,26 @@ private:
     bool  gameOver = false;
     int   winner = 0;          // 0=none/draw, 1=red, 2=yellow
     int   movesMade = 0;
+    Connect4AI ai;
+    SearchStats aiStats;       // counters from the last aiChooseMove, the search runs on this thread
 
     // UI layout / input
     float cell = 64.0f;
     ImVec2 boardTopLeft{0,0};
     int   hoverColumn = -1;
     bool  animateDrops = true;
+    bool  showAnalysis = false;
+    std::unique_ptr<Connect4Analysis> analysis;
+    int   analysisPlayer = 0;  // side to move in the position being analysed
+    int   boardVertices = 0;   // what the board, discs and hover disc added to the draw list last frame
+
+    // The board and a disc are rasterized once per cell size, after that the board is one quad
+    // and every disc is one tinted quad instead of a tessellated circle.
+    ImTextureID boardTexture = 0;
+    ImTextureID diskTexture = 0;
+    ImVec2 boardTextureSize{0,0};
+    ImVec2 diskTextureSize{0,0};
+    float texturesCell = 0.0f;
 
     // Drop animation (one at a time)
     struct DropAnim {
@@ -77,6 +112,7 @@ private:
 
     // --- Helpers ---
     void resetBoard();
+    void refreshResult();
     bool applyMove(int col, int player, int& outRow);
     bool canPlay(int col) const;
     std::vector<int> legalMoves() const;
@@ -95,6 +131,10 @@ private:
     void drawGridBackground(ImDrawList* drawList, const ImVec2& p, float size);
     void drawDisk(ImDrawList* drawList, const ImVec2& center, float radius, int color);
     void drawHoverIndicator(ImDrawList* drawList);
+    void updateAnalysis();
+    void drawAnalysis(ImDrawList* drawList, const ImVec2& rowTopLeft);
+    void ensureTextures();
+    void releaseTextures();
     void launchDropAnim(int col, int row, int color);
     void stepDropAnim(float dt);
 
@@ -102,16 +142,6 @@ private:
     void nextTurn();
     void concludeIfTerminal();
 
-    // --- AI (minimax with alpha-beta, depth-limited) ---
+    // --- AI (minimax with alpha-beta, depth-limited, see Connect4AI) ---
     int aiChooseMove();
-    int evaluateBoard(const Board& b, int me) const;
-    int scoreWindow(const std::array<int,4>& w, int me) const;
-    int minimax(Board b, int depth, int alpha, int beta, bool maximizing, int me);
-
-    // board sims for AI
-    static bool simApply(Board& b, int col, int player);
-    static bool simCanPlay(const Board& b, int col);
-    static std::vector<int> simMoves(const Board& b);
-    static bool simWinAt(const Board& b, int col, int row, int player);
-    static int  simCountDir(const Board& b, int c, int r, int dc, int dr, int player);
 };
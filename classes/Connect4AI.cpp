@@ -0,0 +1,33 @@
+#include "Connect4AI.h"
+#include "Profiler.h"
+
+Connect4AI::Connect4AI()
+    : _engine(kTableSize)
+{
+    // with killers, history and the table ordering the moves a window around the last
+    // iteration's score misses more often than it saves, connect4_bench measures it
+    Options options;
+    options.aspiration = false;
+    options.aspirationWindow = kAspirationWindow;
+    _engine.setOptions(options);
+}
+
+Connect4AI::Result Connect4AI::search(const Connect4Position::Board &board, int me, int depth)
+{
+    PROFILE_SCOPE("Connect4AI::search");
+    Result result;
+    Connect4Position position(board, me);
+    int cols[Connect4Position::kMaxMoves];
+    int count = position.generateMoves(cols);
+    if (count == 0) {
+        return result;
+    }
+
+    AlphaBeta<Connect4Position>::Result found = _engine.search(position, cols, count, depth, AlphaBeta<Connect4Position>::kNoTimeLimit);
+    result.column = found.move;
+    result.score = found.score;
+    result.depth = found.depth;
+    result.nodes = found.nodes;
+    result.found = found.found;
+    return result;
+}
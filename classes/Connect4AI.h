@@ -0,0 +1,51 @@
+#pragma once
+
+#include "AlphaBeta.h"
+#include "Connect4Position.h"
+#include "SearchStats.h"
+#include <cstdint>
+#include <cstdlib>
+
+//
+// the connect 4 opponent: the shared AlphaBeta engine on a Connect4Position, to a fixed depth.
+// a win is spotted as the disc that makes it goes in and is worth more the sooner it comes,
+// so the AI takes the quickest win it can see and puts off a loss as long as it can.
+// the whole search plays into and takes back from one position, nothing is copied per node,
+// and the transposition table is kept from move to move.
+//
+
+class Connect4AI
+{
+public:
+    struct Result
+    {
+        int         column = -1;
+        int         score = 0;
+        int         depth = 0;
+        uint64_t    nodes = 0;
+        bool        found = false;
+    };
+
+    using Options = AlphaBeta<Connect4Position>::Options;
+
+    static const int kWinScore = Connect4Position::kWinScore;
+    // half width of the first aspiration window, about one open three in a row
+    static const int kAspirationWindow = 120;
+    static const size_t kTableSize = 1 << 18;
+
+    Connect4AI();
+
+    // the best column for me (1 red, 2 yellow) to play on board
+    Result      search(const Connect4Position::Board &board, int me, int depth);
+    // counters of the last search
+    SearchStats stats() const { return _engine.stats(); }
+
+    static bool isWin(int score) { return AlphaBeta<Connect4Position>::isWin(score); }
+    static int  pliesToWin(int score) { return kWinScore - std::abs(score); }
+
+    const Options &options() const { return _engine.options(); }
+    void        setOptions(const Options &options) { _engine.setOptions(options); }
+
+private:
+    AlphaBeta<Connect4Position> _engine;
+};
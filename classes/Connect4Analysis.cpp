@@ -0,0 +1,86 @@
+#include "Connect4Analysis.h"
+#include <algorithm>
+
+namespace {
+    // deeper than this the analysis stops on its own
+    const int kMaxDepth = 20;
+}
+
+Connect4Analysis::Connect4Analysis()
+    : _table(kTableSize), _engine(_table)
+{
+    _engine.setRootListener([this](int index, int depth, int score) { columnScored(index, depth, score); });
+}
+
+Connect4Analysis::~Connect4Analysis()
+{
+    stop();
+}
+
+void Connect4Analysis::stop()
+{
+    _stop.store(true);
+    _engine.stop();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void Connect4Analysis::start(const Board &board, int player)
+{
+    stop();
+    _board = board;
+    Connect4Position position(board, player);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _snapshot = Snapshot();
+        for (int c = 0; c < kCols; c++) {
+            _snapshot.columns[c].legal = position.canPlay(c);
+        }
+    }
+    _stop.store(false);
+    _engine.clearStop();
+    _finished.store(false);
+    _thread = std::thread(&Connect4Analysis::run, this, board, player);
+}
+
+Connect4Analysis::Snapshot Connect4Analysis::latest() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _snapshot;
+}
+
+//
+// a column's score is published as soon as its search at the new depth is done, and a depth
+// counts as finished once every legal column has it
+//
+void Connect4Analysis::columnScored(int index, int depth, int score)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    ColumnScore &column = _snapshot.columns[_rootColumns[index]];
+    column.depth = depth;
+    column.score = score;
+    int finished = depth;
+    for (const ColumnScore &other : _snapshot.columns) {
+        if (other.legal) {
+            finished = std::min(finished, other.depth);
+        }
+    }
+    _snapshot.depth = finished;
+}
+
+//
+// every legal column is searched with the full window, so each one gets an exact score
+// rather than just being shown worse than the best
+//
+void Connect4Analysis::run(Board board, int player)
+{
+    Connect4Position position(board, player);
+    int count = position.generateMoves(_rootColumns);
+    int empty = kCols * kRows - position.moveCount();
+    _engine.search(position, _rootColumns, count, std::min(empty, kMaxDepth), AlphaBeta<Connect4Position>::kNoTimeLimit);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _snapshot.finished = !_stop.load();
+    _finished.store(true);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "AlphaBeta.h"
+#include "Connect4Position.h"
+#include "TranspositionTable.h"
+#include <cstdlib>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+//
+// background analysis for reviewing connect 4 games: a score for every legal column.
+// the shared AlphaBeta engine deepens one ply at a time on a worker thread with every root
+// column given its own full window, and the table is kept between positions so stepping
+// through a game reuses what the neighbouring positions already worked out.
+// scores are from the side to move's view.
+//
+
+class Connect4Analysis
+{
+public:
+    using Board = Connect4Position::Board;
+    static const int kCols = 7;
+    static const int kRows = 6;
+    static const int kWinScore = Connect4Position::kWinScore;
+
+    struct ColumnScore
+    {
+        bool    legal = false;
+        int     depth = 0;      // 0 until the first iteration finishes this column
+        int     score = 0;
+    };
+
+    struct Snapshot
+    {
+        std::array<ColumnScore, kCols> columns;
+        int     depth = 0;      // last iteration finished for every column
+        bool    finished = false;
+    };
+
+    Connect4Analysis();
+    ~Connect4Analysis();
+    Connect4Analysis(const Connect4Analysis &) = delete;
+    Connect4Analysis &operator=(const Connect4Analysis &) = delete;
+
+    // analyse board with player (1 red, 2 yellow) to move, a search already running is stopped first
+    void        start(const Board &board, int player);
+    void        stop();
+    bool        running() const { return _thread.joinable() && !_finished.load(); }
+    const Board &board() const { return _board; }
+
+    // the scores so far, safe to call while the worker runs
+    Snapshot    latest() const;
+
+    // a score that is a forced result rather than an evaluation, and how many plies away it is
+    static bool isWin(int score) { return AlphaBeta<Connect4Position>::isWin(score); }
+    static int  pliesToWin(int score) { return kWinScore - std::abs(score); }
+
+private:
+    static const size_t kTableSize = 1 << 20;
+
+    void        run(Board board, int player);
+    void        columnScored(int index, int depth, int score);
+
+    TranspositionTable      _table;
+    AlphaBeta<Connect4Position> _engine;
+    int                     _rootColumns[kCols] = {};   // the engine's root moves, set by run
+    std::thread             _thread;
+    std::atomic<bool>       _stop{false};
+    std::atomic<bool>       _finished{true};
+    Board                   _board{};
+
+    mutable std::mutex      _mutex;
+    Snapshot                _snapshot;
+};
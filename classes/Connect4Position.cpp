@@ -0,0 +1,118 @@
+#include "Connect4Position.h"
+
+namespace {
+    // centre columns first, they take part in the most lines
+    const int kColumnOrder[Connect4Position::kCols] = {3, 2, 4, 1, 5, 0, 6};
+}
+
+Connect4Position::Connect4Position(const Board &board, int toMove)
+    : _board(board), _toMove(toMove)
+{
+    for (int c = 0; c < kCols; c++) {
+        while (_heights[c] < kRows && _board[c][_heights[c]] != 0) {
+            _key ^= discKey(c, _heights[c], _board[c][_heights[c]]);
+            _heights[c]++;
+        }
+        _moveCount += _heights[c];
+    }
+    _rootCount = _moveCount;
+}
+
+int Connect4Position::generateMoves(Move *cols) const
+{
+    int count = 0;
+    for (int col : kColumnOrder) {
+        if (_heights[col] < kRows) {
+            cols[count++] = col;
+        }
+    }
+    return count;
+}
+
+bool Connect4Position::terminal(int ply, int &score) const
+{
+    // only the disc just played can have made a four, anything older would have ended it sooner
+    int col = lastMove();
+    if (col >= 0) {
+        int row = _heights[col] - 1;
+        if (winAt(col, row, _board[col][row])) {
+            score = -(kWinScore - ply);
+            return true;
+        }
+    }
+    if (full()) {
+        score = 0;
+        return true;
+    }
+    return false;
+}
+
+bool Connect4Position::winAt(const Board &board, int col, int row, int player)
+{
+    auto line = [&](int dc, int dr) {
+        int total = 1;
+        int cc = col - dc, rr = row - dr;
+        while (cc >= 0 && cc < kCols && rr >= 0 && rr < kRows && board[cc][rr] == player) { total++; cc -= dc; rr -= dr; }
+        cc = col + dc; rr = row + dr;
+        while (cc >= 0 && cc < kCols && rr >= 0 && rr < kRows && board[cc][rr] == player) { total++; cc += dc; rr += dr; }
+        return total >= 4;
+    };
+    return line(1, 0) || line(0, 1) || line(1, 1) || line(1, -1);
+}
+
+int Connect4Position::evaluate(const Board &board, int me)
+{
+    int opp = (me == 1) ? 2 : 1;
+    auto scoreFor = [&](int who) -> int {
+        int s = 0;
+
+        // center preference
+        int centerCount = 0;
+        for (int r = 0; r < kRows; ++r) if (board[3][r] == who) centerCount++;
+        s += centerCount * 6;
+
+        auto scoreLine = [&](int c0, int r0, int dc, int dr) {
+            std::array<int, 4> w{};
+            int sLocal = 0;
+            for (;;) {
+                int c = c0, r = r0;
+                for (int i = 0; i < 4; ++i) {
+                    if (c < 0 || c >= kCols || r < 0 || r >= kRows) return sLocal;
+                    w[i] = board[c][r]; c += dc; r += dr;
+                }
+                sLocal += scoreWindow(w, who);
+                c0 += dc; r0 += dr;
+            }
+        };
+
+        // Horizontal rows
+        for (int r = 0; r < kRows; ++r) s += scoreLine(0, r, 1, 0);
+        // Vertical cols
+        for (int c = 0; c < kCols; ++c) s += scoreLine(c, 0, 0, 1);
+        // Diagonals /
+        for (int c = 0; c <= kCols - 4; ++c) s += scoreLine(c, kRows - 4, 1, 1);
+        for (int r = kRows - 4; r >= 0; --r) s += scoreLine(0, r, 1, 1);
+        // Diagonals going down to the right, from the left edge only
+        for (int r = 3; r < kRows; ++r) s += scoreLine(0, r, 1, -1);
+
+        return s;
+    };
+
+    return scoreFor(me) - scoreFor(opp);
+}
+
+int Connect4Position::scoreWindow(const std::array<int, 4> &w, int me)
+{
+    int opp = (me == 1) ? 2 : 1;
+    int meCnt = 0, oppCnt = 0, empty = 0;
+    for (int v : w) { if (v == me) meCnt++; else if (v == opp) oppCnt++; else empty++; }
+
+    if (meCnt == 4) return 10000;
+    if (meCnt == 3 && empty == 1) return 100;
+    if (meCnt == 2 && empty == 2) return 12;
+
+    if (oppCnt == 3 && empty == 1) return -120; // block threats more urgently
+    if (oppCnt == 4) return -10000;
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+//
+// a connect 4 position the AI can play into and take back in place, and the position the
+// shared AlphaBeta engine searches (see SearchPosition).
+// the height of every column says where the next disc lands without scanning, and a stack of
+// the columns played says which disc went in last, so a whole search shares one position
+// instead of copying the board for every node. a zobrist key follows the discs in and out.
+//
+
+class Connect4Position
+{
+public:
+    static const int kCols = 7;
+    static const int kRows = 6;
+    // 0 = empty, 1 = red, 2 = yellow
+    using Board = std::array<std::array<int, kRows>, kCols>;
+
+    // what the engine needs: a move is a column
+    using Move = int;
+    static const int kMaxMoves = kCols;
+    static const int kMoveKeys = kCols;
+    // a forced result scores kWinScore less the plies until the four is made
+    static const int kWinScore = 100000;
+
+    Connect4Position() = default;
+    // toMove is the player (1 red, 2 yellow) who drops the next disc
+    explicit Connect4Position(const Board &board, int toMove = 1);
+
+    const Board &board() const { return _board; }
+    int         at(int col, int row) const { return _board[col][row]; }
+    int         height(int col) const { return _heights[col]; }
+    int         moveCount() const { return _moveCount; }
+    int         toMove() const { return _toMove; }
+    bool        full() const { return _moveCount == kCols * kRows; }
+    bool        canPlay(int col) const { return col >= 0 && col < kCols && _heights[col] < kRows; }
+    // the column played last, -1 at the start of the stack
+    int         lastMove() const { return _moveCount > _rootCount ? _moves[_moveCount - 1] : -1; }
+
+    // the playable columns, centre out
+    int         generateMoves(Move *cols) const;
+
+    // drop a disc for the side to move, the column must have room
+    void        play(int col)
+    {
+        int row = _heights[col]++;
+        _board[col][row] = _toMove;
+        _key ^= discKey(col, row, _toMove);
+        _moves[_moveCount++] = (int8_t)col;
+        _toMove = 3 - _toMove;
+    }
+    // take back the last disc, its column comes off the move stack. only discs played since
+    // the position was made can be taken back
+    void        undo()
+    {
+        int col = _moves[--_moveCount];
+        int row = --_heights[col];
+        _key ^= discKey(col, row, _board[col][row]);
+        _board[col][row] = 0;
+        _toMove = 3 - _toMove;
+    }
+    // the engine hands back the column it played, which is always the last one
+    void        undo(int col)
+    {
+        assert(col == lastMove());
+        undo();
+    }
+
+    // the discs and the side to move
+    uint64_t    hash() const { return _toMove == 2 ? _key ^ kYellowToMove : _key; }
+    // the last disc made four, which lost it for the side to move, or the board is full
+    bool        terminal(int ply, int &score) const;
+    int         noMovesScore(int) const { return 0; }
+    int         moveKey(Move col) const { return col; }
+
+    // does the disc at col, row make four for player
+    bool        winAt(int col, int row, int player) const { return winAt(_board, col, row, player); }
+
+    // static evaluation from the side to move's point of view
+    int         evaluate() const { return evaluate(_board, _toMove); }
+
+    static bool winAt(const Board &board, int col, int row, int player);
+    // the evaluation is symmetric, evaluate(board, 1) == -evaluate(board, 2)
+    static int  evaluate(const Board &board, int me);
+    // the zobrist key of player's disc at col, row
+    static uint64_t discKey(int col, int row, int player) { return kDiscKeys[(col * kRows + row) * 2 + player - 1]; }
+
+private:
+    // splitmix from a fixed seed, so the keys come out the same every run
+    static constexpr std::array<uint64_t, kCols * kRows * 2 + 1> kDiscKeys = [] {
+        std::array<uint64_t, kCols * kRows * 2 + 1> keys{};
+        uint64_t state = 0x43344b455953ull;
+        for (uint64_t &key : keys) {
+            uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            key = z ^ (z >> 31);
+        }
+        return keys;
+    }();
+    static constexpr uint64_t kYellowToMove = kDiscKeys[kCols * kRows * 2];
+
+    static int  scoreWindow(const std::array<int, 4> &window, int me);
+
+    Board       _board{};
+    int         _heights[kCols] = {};
+    int8_t      _moves[kCols * kRows] = {};
+    int         _moveCount = 0;
+    int         _rootCount = 0;     // discs already on the board it was made from
+    int         _toMove = 1;
+    uint64_t    _key = 0;
+};
@@ -1,8 +1,9 @@
 #include "Game.h"
 #include "Bit.h"
 #include "BitHolder.h"
-#include "Turn.h"
+#include "Profiler.h"
 #include "../Application.h"
+#include <cfloat>
 
 Game::Game()
 {
@@ -16,6 +17,7 @@ Game::Game()
 	_gameOptions.score = 0;
 	_gameOptions.AIDepthSearches = 0;
 	_gameOptions.AIvsAI = false;
+	_historyCursor = 0;
 
 	_table = nullptr;
 	_winner = nullptr;
@@ -32,11 +34,6 @@ Game::Game()
 
 Game::~Game()
 {
-	for (auto &_turn : _turns)
-	{
-		delete _turn;
-	}
-	_turns.clear();
 	for (auto &_player : _players)
 	{
 		delete _player;
@@ -65,10 +62,6 @@ void Game::setNumberOfPlayers(unsigned int n)
 
 	_gameOptions.gameNumber = 0;
 	_gameOptions.numberOfPlayers = n;
-
-	Turn *turn = Turn::initStartOfGame(this);
-	_turns.clear();
-	_turns.push_back(turn);
 }
 
 void Game::setAIPlayer(unsigned int playerNumber)
@@ -80,26 +73,136 @@ void Game::setAIPlayer(unsigned int playerNumber)
 
 void Game::startGame()
 {
-	std::string startState = stateString();
-	Turn *turn = _turns.at(0);
-	turn->_boardState = startState;
-	turn->_gameNumber = _gameOptions.gameNumber;
+	_history.start(snapshot());
+	_historyCursor = 0;
 	_gameOptions.currentTurnNo = 0;
 }
 
 void Game::endTurn()
 {
 	_gameOptions.currentTurnNo++;
-	std::string startState = stateString();
-	Turn *turn = new Turn;
-	turn->_boardState = stateString();
-	turn->_date = (int)_gameOptions.currentTurnNo;
-	turn->_score = _gameOptions.score;
-	turn->_gameNumber = _gameOptions.gameNumber;
-	_turns.push_back(turn);
+	commitTurn();
 	ClassGame::EndOfTurn();
 }
 
+void Game::recordMove(uint32_t move, bool turnContinues)
+{
+	// a move made from an earlier position replaces everything after it
+	_history.truncate(_historyCursor);
+	_history.record(turnContinues ? (move | GameHistory::kTurnContinues) : move);
+	_historyCursor = _history.moveCount();
+}
+
+//
+// full states are only taken now and then, the moves in between are enough to get back to any turn
+//
+void Game::commitTurn()
+{
+	if (_history.keyframeDue())
+	{
+		_history.addKeyframe(snapshot());
+	}
+}
+
+void Game::undoMove()
+{
+	if (!canUndo())
+	{
+		return;
+	}
+	uint32_t move = _history.moveAt(--_historyCursor);
+	unapplyMove(move);
+	if (!(move & GameHistory::kTurnContinues))
+	{
+		_gameOptions.currentTurnNo--;
+	}
+}
+
+void Game::redoMove()
+{
+	if (!canRedo())
+	{
+		return;
+	}
+	uint32_t move = _history.moveAt(_historyCursor++);
+	applyMove(move);
+	if (!(move & GameHistory::kTurnContinues))
+	{
+		_gameOptions.currentTurnNo++;
+	}
+}
+
+//
+// each step only touches the pieces that move changed, so scrubbing a whole game is cheap
+//
+void Game::seekHistory(int moveIndex)
+{
+	moveIndex = std::clamp(moveIndex, 0, _history.moveCount());
+	while (_historyCursor > moveIndex)
+	{
+		undoMove();
+	}
+	while (_historyCursor < moveIndex)
+	{
+		redoMove();
+	}
+}
+
+void Game::resumeFromHistory()
+{
+	_history.truncate(_historyCursor);
+}
+
+BoardSnapshot Game::snapshotAtMove(int moveIndex) const
+{
+	moveIndex = std::clamp(moveIndex, 0, _history.moveCount());
+	const GameHistory::Keyframe &keyframe = _history.keyframeBefore(moveIndex);
+	BoardSnapshot state = keyframe.state;
+	for (int i = keyframe.moveIndex; i < moveIndex; i++)
+	{
+		applyMoveToSnapshot(state, _history.moveAt(i));
+	}
+	return state;
+}
+
+//
+// position files are a short header and one encoded snapshot, loading one starts a fresh
+// history from that position with its side to move
+//
+static const char kPositionMagic[4] = {'B', 'P', 'O', 'S'};
+
+bool Game::savePosition(const std::string &path)
+{
+	uint8_t bytes[BoardSnapshot::kEncodedSize];
+	snapshot().encode(bytes);
+	std::ofstream file(path, std::ios::binary);
+	file.write(kPositionMagic, sizeof(kPositionMagic));
+	file.write((const char *)bytes, sizeof(bytes));
+	return (bool)file;
+}
+
+bool Game::loadPosition(const std::string &path)
+{
+	char magic[sizeof(kPositionMagic)];
+	uint8_t bytes[BoardSnapshot::kEncodedSize];
+	std::ifstream file(path, std::ios::binary);
+	file.read(magic, sizeof(magic));
+	file.read((char *)bytes, sizeof(bytes));
+	BoardSnapshot position;
+	if (!file || !std::equal(magic, magic + sizeof(magic), kPositionMagic) || !position.decode(bytes))
+	{
+		return false;
+	}
+	if (!restoreSnapshot(position))
+	{
+		return false;
+	}
+	_gameOptions.currentTurnNo = position.sideToMove;
+	_history.start(position);
+	_historyCursor = 0;
+	return true;
+}
+
 //
 // scan for mouse is temporarily in the actual game class
 // this will be moved to a higher up class when the squares have a heirarchy
@@ -108,10 +211,15 @@ void Game::endTurn()
 //
 void Game::scanForMouse()
 {
+	PROFILE_SCOPE("Game::scanForMouse");
 	if (gameHasAI() && getCurrentPlayer()->isAIPlayer())
 	{
 		return;
 	}
+	if (isReviewingHistory())
+	{
+		return;
+	}
 #if defined(UCI_INTERFACE)
 	return;
 #endif
@@ -119,56 +227,59 @@ void Game::scanForMouse()
 	mousePos.x -= ImGui::GetWindowPos().x;
 	mousePos.y -= ImGui::GetWindowPos().y;
 
-	Entity *entity = nullptr;
-	Grid* grid = getGrid();
-	grid->forEachEnabledSquare([&](ChessSquare* square, int x, int y) {
-		Bit *bit = square->bit();
-		if (bit && bit->isMouseOver(mousePos))
-		{
-			entity = bit;
-		}
-		else if (square->isMouseOver(mousePos))
-		{
-			entity = square;
-		}
-	});
+	// only a click or a release needs to know what is under the mouse, moving never looks
 	if (ImGui::IsMouseClicked(0))
 	{
+		Entity *entity = entityAtPoint(mousePos);
 		mouseDown(mousePos, entity);
 	}
 	else if (ImGui::IsMouseReleased(0))
 	{
+		Entity *entity = entityAtPoint(mousePos);
 		mouseUp(mousePos, entity);
 	}
 	else
 	{
-		mouseMoved(mousePos, entity);
+		mouseMoved(mousePos, nullptr);
+	}
+}
+
+//
+// the piece under the point if there is one, otherwise the square
+//
+Entity *Game::entityAtPoint(const ImVec2 &pos)
+{
+	ChessSquare *square = getGrid()->squareAtPoint(pos);
+	if (!square)
+	{
+		return nullptr;
+	}
+	Bit *bit = square->bit();
+	if (bit && bit->isMouseOver(pos))
+	{
+		return bit;
 	}
+	return square;
 }
 
 void Game::findDropTarget(ImVec2 &pos)
 {
-	Grid* grid = getGrid();
-	grid->forEachEnabledSquare([&](ChessSquare* square, int x, int y) {
-		if (square == _oldHolder)
-		{
-			return;
-		}
-		if (square->isMouseOver(pos))
-		{
-			if (_dropTarget && square != _dropTarget)
-			{
-				_dropTarget->willNotDropBit(_dragBit);
-				_dropTarget->setHighlighted(false);
-				_dropTarget = nullptr;
-			}
-			if (_oldHolder && square->canDropBitAtPoint(_dragBit, pos) && canBitMoveFromTo(*_dragBit, *_oldHolder, *square))
-			{
-				_dropTarget = square;
-				_dropTarget->setHighlighted(true);
-			}
-		}
-	});
+	ChessSquare *square = getGrid()->squareAtPoint(pos);
+	if (!square || square == _oldHolder)
+	{
+		return;
+	}
+	if (_dropTarget && square != _dropTarget)
+	{
+		_dropTarget->willNotDropBit(_dragBit);
+		_dropTarget->setHighlighted(false);
+		_dropTarget = nullptr;
+	}
+	if (_oldHolder && square->canDropBitAtPoint(_dragBit, pos) && canBitMoveFromTo(*_dragBit, *_oldHolder, *square))
+	{
+		_dropTarget = square;
+		_dropTarget->setHighlighted(true);
+	}
 }
 
 //
@@ -177,8 +288,29 @@ void Game::findDropTarget(ImVec2 &pos)
 //
 void Game::drawFrame()
 {
+	PROFILE_SCOPE("Game::drawFrame");
 	scanForMouse();
 
+	auto start = std::chrono::steady_clock::now();
+	if (_batchedDrawing)
+	{
+		paintBatched();
+	}
+	else
+	{
+		paintSprites();
+	}
+	// smoothed so the number in the settings panel is readable
+	float elapsedMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	_paintTimeMs += (elapsedMs - _paintTimeMs) * 0.05f;
+}
+
+//
+// the original drawing, one ImGui::Image item per sprite over four passes of the board.
+// kept for comparing against paintBatched
+//
+void Game::paintSprites()
+{
 	Grid* grid = getGrid();
 
 	// Paint squares
@@ -195,11 +327,13 @@ void Game::drawFrame()
 	});
 
 	// Paint moving pieces
-	grid->forEachEnabledSquare([](ChessSquare* square, int x, int y) {
+	_piecesMoving = false;
+	grid->forEachEnabledSquare([this](ChessSquare* square, int x, int y) {
 		if (square->bit() && square->bit()->getMoving() && !square->bit()->getPickedUp())
 		{
 			square->bit()->update();
 			square->bit()->paintSprite();
+			_piecesMoving |= square->bit()->getMoving();
 		}
 	});
 
@@ -212,6 +346,95 @@ void Game::drawFrame()
 	});
 }
 
+//
+// one walk of the board sorts every sprite into its layer, then each layer goes straight
+// into the window draw list with one texture change per distinct texture, so the number of
+// draw commands depends on how many textures are on the board rather than how many squares.
+// a single dummy item keeps the window's content size the same as the per sprite version
+//
+void Game::paintBatched()
+{
+	for (std::vector<Sprite *> &layer : _drawLayers)
+	{
+		layer.clear();
+	}
+	ImVec2 extentMin(FLT_MAX, FLT_MAX);
+	ImVec2 extentMax(0.0f, 0.0f);
+	bool anyHighlighted = false;
+	_piecesMoving = false;
+
+	getGrid()->forEachEnabledSquare([&](ChessSquare *square, int x, int y) {
+		if (square->isDrawable())
+		{
+			_drawLayers[kSquareLayer].push_back(square);
+			const ImVec2 &pos = square->getPosition();
+			extentMin = ImVec2(std::min(extentMin.x, pos.x), std::min(extentMin.y, pos.y));
+			extentMax = ImVec2(std::max(extentMax.x, pos.x + square->getSize().x), std::max(extentMax.y, pos.y + square->getSize().y));
+			anyHighlighted |= square->highlighted();
+		}
+		Bit *bit = square->bit();
+		if (!bit || !bit->isDrawable())
+		{
+			return;
+		}
+		if (bit->getPickedUp())
+		{
+			_drawLayers[kPickedUpLayer].push_back(bit);
+		}
+		else if (bit->getMoving())
+		{
+			bit->update();
+			_drawLayers[kMovingLayer].push_back(bit);
+			_piecesMoving |= bit->getMoving();
+		}
+		else
+		{
+			_drawLayers[kPieceLayer].push_back(bit);
+		}
+	});
+	if (_drawLayers[kSquareLayer].empty())
+	{
+		return;
+	}
+
+	ImDrawList *drawList = ImGui::GetWindowDrawList();
+	ImVec2 origin = ImGui::GetWindowPos();
+	origin.x -= ImGui::GetScrollX();
+	origin.y -= ImGui::GetScrollY();
+
+	for (int layer = 0; layer < kDrawLayerCount; layer++)
+	{
+		std::vector<Sprite *> &sprites = _drawLayers[layer];
+		std::sort(sprites.begin(), sprites.end(), [](Sprite *a, Sprite *b) {
+			return a->getTexture() != b->getTexture() ? a->getTexture() < b->getTexture() : a < b;
+		});
+		for (size_t i = 0; i < sprites.size();)
+		{
+			ImTextureID texture = sprites[i]->getTexture();
+			drawList->PushTexture(texture);
+			for (; i < sprites.size() && sprites[i]->getTexture() == texture; i++)
+			{
+				sprites[i]->primSprite(drawList, origin);
+			}
+			drawList->PopTexture();
+		}
+		// highlight frames use the font atlas, so they go in after the textured squares
+		if (layer == kSquareLayer && anyHighlighted)
+		{
+			for (Sprite *square : sprites)
+			{
+				if (square->highlighted())
+				{
+					square->paintHighlight(drawList, origin);
+				}
+			}
+		}
+	}
+
+	ImGui::SetCursorPos(extentMin);
+	ImGui::Dummy(ImVec2(extentMax.x - extentMin.x, extentMax.y - extentMin.y));
+}
+
 void Game::bitMovedFromTo(Bit &bit, BitHolder &src, BitHolder &dst)
 {
 	endTurn();
@@ -246,6 +469,14 @@ void Game::updateAI()
 {
 }
 
+//
+// the AI waits while an earlier position is on the board
+//
+bool Game::isWaitingOnAI()
+{
+	return gameHasAI() && !isReviewingHistory() && (getCurrentPlayer()->isAIPlayer() || _gameOptions.AIvsAI);
+}
+
 void Game::mouseDown(ImVec2 &location, Entity *entity)
 {
 	bool placing = false;
@@ -18,10 +18,12 @@
 #endif
 
 #include "Player.h"
-#include "Turn.h"
+#include "GameHistory.h"
 #include "Bit.h"
+#include "BitPool.h"
 #include "BitHolder.h"
 #include "Grid.h"
+#include "SearchStats.h"
 
 
 const int AI_PLAYER = 1;
@@ -55,6 +57,10 @@ public:
 	virtual void setUpBoard() = 0;
 
 	virtual void drawFrame();
+	// draw the board through the batched path or one ImGui item per sprite, and how long it took
+	bool batchedDrawing() const { return _batchedDrawing; }
+	void setBatchedDrawing(bool batched) { _batchedDrawing = batched; }
+	float paintTimeMs() const { return _paintTimeMs; }
 
 	// end the current game turn
 	virtual void endTurn();
@@ -95,12 +101,45 @@ public:
 	virtual void stopGame() = 0;
 	virtual bool gameHasAI();
 	virtual void updateAI();
+	// true while it is an AI's turn, updateAI has to keep being called every frame until it moves
+	virtual bool isWaitingOnAI();
+	// counters from the AI's current or last search, false for games whose AI doesn't report any
+	virtual bool aiSearchStats(SearchStats &stats) { return false; }
+	// true while pieces are still sliding into place from the last frame's drawing
+	virtual bool isAnimating() { return _piecesMoving; }
 	virtual void pieceTaken(Bit *bit){};
 
 	virtual std::string initialStateString() = 0;
 	virtual std::string stateString() = 0;
 	virtual void setStateString(const std::string &s) = 0;
 
+	// binary form of the position, the string form above is kept for display.
+	// restoreSnapshot returns false if the snapshot is for another game or board size
+	virtual BoardSnapshot snapshot() = 0;
+	virtual bool restoreSnapshot(const BoardSnapshot &snapshot) = 0;
+	bool savePosition(const std::string &path);
+	bool loadPosition(const std::string &path);
+
+	// move history, each game encodes its own moves into one word and knows how to
+	// replay one onto a snapshot
+	void recordMove(uint32_t move, bool turnContinues = false);
+	void commitTurn();
+	const GameHistory &history() const { return _history; }
+	BoardSnapshot snapshotAtMove(int moveIndex) const;
+	virtual void applyMoveToSnapshot(BoardSnapshot &snapshot, uint32_t move) const {};
+
+	// stepping through the history on the live board, one move at a time.
+	// while the cursor is behind the last move the game is being reviewed and takes no input,
+	// resumeFromHistory drops the moves after the cursor and play carries on from there.
+	int historyCursor() const { return _historyCursor; }
+	bool isReviewingHistory() const { return _historyCursor < _history.moveCount(); }
+	bool canUndo() const { return _historyCursor > 0; }
+	bool canRedo() const { return isReviewingHistory(); }
+	void undoMove();
+	void redoMove();
+	void seekHistory(int moveIndex);
+	void resumeFromHistory();
+
 	void setNumberOfPlayers(unsigned int playerCount);
 	void setAIPlayer(unsigned int playerNumber);
 	virtual int getAIDepathSearches() { return _gameOptions.AIDepthSearches; };
@@ -131,17 +170,44 @@ public:
 	Player *_winner;
 
 	std::vector<Player *> _players;
-	std::vector<Turn *> _turns;
+	GameHistory _history;
 
 	std::string _lastMove;
 
 	GameOptions _gameOptions;
 
+	// every piece this game puts on the board comes from here
+	BitPool _bitPool;
+
 protected:
+	// put a recorded move back on the board or take it off again, without touching the history.
+	// the whole word is passed so games can see GameHistory::kTurnContinues
+	virtual void applyMove(uint32_t move) {};
+	virtual void unapplyMove(uint32_t move) {};
+
+	int _historyCursor;
+
 	void mouseDown(ImVec2 &location, Entity *bit);
 	void mouseMoved(ImVec2 &location, Entity *bit);
 	void mouseUp(ImVec2 &location, Entity *bit);
 	void findDropTarget(ImVec2 &pos);
+	Entity *entityAtPoint(const ImVec2 &pos);
+	void paintSprites();
+	void paintBatched();
+
+	// sprites waiting to be drawn, bottom layer first, reused every frame
+	enum DrawLayer
+	{
+		kSquareLayer,
+		kPieceLayer,
+		kMovingLayer,
+		kPickedUpLayer,
+		kDrawLayerCount
+	};
+	std::vector<Sprite *> _drawLayers[kDrawLayerCount];
+	bool _batchedDrawing = true;
+	float _paintTimeMs = 0.0f;
+	bool _piecesMoving = false;
 
 	ImVec2 _dragStartPos;
 	ImVec2 _dragOffset;
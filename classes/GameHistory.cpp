@@ -0,0 +1,47 @@
+#include "GameHistory.h"
+#include <algorithm>
+
+void GameHistory::start(const BoardSnapshot &state)
+{
+    _moves.clear();
+    _keyframes.clear();
+    _keyframes.push_back({0, state});
+}
+
+bool GameHistory::keyframeDue() const
+{
+    return _keyframes.empty() || moveCount() - _keyframes.back().moveIndex >= kKeyframeInterval;
+}
+
+void GameHistory::addKeyframe(const BoardSnapshot &state)
+{
+    _keyframes.push_back({moveCount(), state});
+}
+
+void GameHistory::truncate(int moveCount)
+{
+    if (moveCount >= this->moveCount()) {
+        return;
+    }
+    _moves.resize(std::max(moveCount, 0));
+    while (_keyframes.size() > 1 && _keyframes.back().moveIndex > moveCount) {
+        _keyframes.pop_back();
+    }
+}
+
+const GameHistory::Keyframe &GameHistory::keyframeBefore(int moveIndex) const
+{
+    static const Keyframe kEmpty;
+    // keyframes are in move order, find the last one not past moveIndex
+    auto it = std::upper_bound(_keyframes.begin(), _keyframes.end(), moveIndex,
+                               [](int index, const Keyframe &keyframe) { return index < keyframe.moveIndex; });
+    if (it == _keyframes.begin()) {
+        return kEmpty;
+    }
+    return *(it - 1);
+}
+
+size_t GameHistory::memoryUsed() const
+{
+    return _moves.capacity() * sizeof(uint32_t) + _keyframes.capacity() * sizeof(Keyframe);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "BoardSnapshot.h"
+#include <cstdint>
+#include <vector>
+
+//
+// compact record of a game: one 32 bit word per move, the encoding is up to each game.
+// a full board state is only kept every kKeyframeInterval moves, any other position is
+// rebuilt from the nearest keyframe before it by replaying the moves in between.
+//
+
+class GameHistory
+{
+public:
+    // set on a move after which the same player is still to move (a multi jump, a pass)
+    static const uint32_t kTurnContinues = 0x80000000u;
+    static const int kKeyframeInterval = 16;
+
+    struct Keyframe
+    {
+        int         moveIndex = 0;      // number of moves played before this state
+        BoardSnapshot state;
+    };
+
+    void        start(const BoardSnapshot &state);
+    void        record(uint32_t move) { _moves.push_back(move); }
+    // call at the end of a turn, a keyframe is only taken when one is due
+    bool        keyframeDue() const;
+    void        addKeyframe(const BoardSnapshot &state);
+    // forget every move from moveCount on, for playing on from an earlier position
+    void        truncate(int moveCount);
+
+    int         moveCount() const { return (int)_moves.size(); }
+    uint32_t    moveAt(int index) const { return _moves[index]; }
+    // the last keyframe at or before moveIndex
+    const Keyframe &keyframeBefore(int moveIndex) const;
+
+    size_t      memoryUsed() const;
+
+private:
+    std::vector<uint32_t> _moves;
+    std::vector<Keyframe> _keyframes;
+};
@@ -1,42 +1,45 @@
 #include "Grid.h"
+#include <algorithm>
 
-Grid::Grid(int width, int height) : _width(width), _height(height)
+Grid::Grid(int width, int height) : _squares(width * height), _width(width), _height(height)
 {
-    // Initialize 2D vectors
-    _squares.resize(height);
-    _enabled.resize(height);
-
-    for (int y = 0; y < height; y++) {
-        _squares[y].resize(width);
-        _enabled[y].resize(width);
-
-        for (int x = 0; x < width; x++) {
-            _squares[y][x] = new ChessSquare();
-            _enabled[y][x] = true; // All squares enabled by default
-        }
+    // All squares enabled by default
+    _enabled.assign((_squares.size() + 63) / 64, 0);
+    _enabledIndices.reserve(_squares.size());
+    for (int index = 0; index < (int)_squares.size(); index++) {
+        _enabled[index >> 6] |= 1ull << (index & 63);
+        _enabledIndices.push_back(index);
     }
 }
 
 Grid::~Grid()
 {
-    for (int y = 0; y < _height; y++) {
-        for (int x = 0; x < _width; x++) {
-            delete _squares[y][x];
-        }
-    }
 }
 
 ChessSquare* Grid::getSquare(int x, int y)
 {
     if (!isValid(x, y)) return nullptr;
-    return _squares[y][x];
+    return &_squares[getIndex(x, y)];
 }
 
 ChessSquare* Grid::getSquareByIndex(int index)
 {
-    int x, y;
-    getCoordinates(index, x, y);
-    return getSquare(x, y);
+    if (index < 0 || index >= (int)_squares.size()) return nullptr;
+    return &_squares[index];
+}
+
+ChessSquare* Grid::squareAtPoint(const ImVec2& point)
+{
+    if (_regularLayout) {
+        float column = (point.x - _layoutOrigin.x) / _squareSize;
+        float row = (point.y - _layoutOrigin.y) / _squareSize;
+        if (column < 0.0f || row < 0.0f || column >= _width || row >= _height) return nullptr;
+        int index = getIndex((int)column, (int)row);
+        return isEnabledIndex(index) ? &_squares[index] : nullptr;
+    }
+    return findFirstEnabled([&](ChessSquare* square, int x, int y) {
+        return square->isMouseOver(point);
+    });
 }
 
 bool Grid::isValid(int x, int y) const
@@ -47,13 +50,23 @@ bool Grid::isValid(int x, int y) const
 bool Grid::isEnabled(int x, int y) const
 {
     if (!isValid(x, y)) return false;
-    return _enabled[y][x];
+    return isEnabledIndex(getIndex(x, y));
 }
 
 void Grid::setEnabled(int x, int y, bool enabled)
 {
-    if (isValid(x, y)) {
-        _enabled[y][x] = enabled;
+    if (!isValid(x, y) || isEnabled(x, y) == enabled) {
+        return;
+    }
+    int index = getIndex(x, y);
+    _enabled[index >> 6] ^= 1ull << (index & 63);
+
+    // keep the enabled list sorted so walks stay in board order
+    auto it = std::lower_bound(_enabledIndices.begin(), _enabledIndices.end(), index);
+    if (enabled) {
+        _enabledIndices.insert(it, index);
+    } else {
+        _enabledIndices.erase(it);
     }
 }
 
@@ -152,21 +165,18 @@ bool Grid::areConnected(int fromX, int fromY, int toX, int toY)
 // Iterator support
 void Grid::forEachSquare(std::function<void(ChessSquare*, int x, int y)> func)
 {
+    int index = 0;
     for (int y = 0; y < _height; y++) {
         for (int x = 0; x < _width; x++) {
-            func(_squares[y][x], x, y);
+            func(&_squares[index++], x, y);
         }
     }
 }
 
 void Grid::forEachEnabledSquare(std::function<void(ChessSquare*, int x, int y)> func)
 {
-    for (int y = 0; y < _height; y++) {
-        for (int x = 0; x < _width; x++) {
-            if (_enabled[y][x]) {
-                func(_squares[y][x], x, y);
-            }
-        }
+    for (int index : _enabledIndices) {
+        func(&_squares[index], index % _width, index / _width);
     }
 }
 
@@ -178,13 +188,20 @@ void Grid::initializeSquares(float squareSize, const char* spriteName)
             initializeSquare(x, y, squareSize, spriteName);
         }
     }
+    // every square now sits at origin + (x, y) * squareSize, so points map straight to cells
+    _regularLayout = squareSize > 0.0f;
+    _squareSize = squareSize;
+    _layoutOrigin = ImVec2(squareSize / 2, squareSize / 2);
 }
 
 void Grid::initializeSquare(int x, int y, float squareSize, const char* spriteName)
 {
     if (isValid(x, y)) {
         ImVec2 position(squareSize * x + squareSize/2, squareSize * y + squareSize/2);
-        _squares[y][x]->initHolder(position, spriteName, x, y);
+        ChessSquare& square = _squares[getIndex(x, y)];
+        square.initHolder(position, spriteName, x, y);
+        square.setSize(squareSize, squareSize);
+        _regularLayout = false;
     }
 }
 
@@ -192,17 +209,14 @@ void Grid::initializeSquare(int x, int y, float squareSize, const char* spriteNa
 std::string Grid::getStateString() const
 {
     std::string state;
-
-    for (int y = 0; y < _height; y++) {
-        for (int x = 0; x < _width; x++) {
-            if (_enabled[y][x]) {
-                Bit* bit = _squares[y][x]->bit();
-                if (bit) {
-                    state += std::to_string(bit->gameTag());
-                } else {
-                    state += '0';
-                }
-            }
+    state.reserve(_enabledIndices.size());
+
+    for (int index : _enabledIndices) {
+        Bit* bit = _squares[index].bit();
+        if (bit) {
+            state += std::to_string(bit->gameTag());
+        } else {
+            state += '0';
         }
     }
 
@@ -211,19 +225,13 @@ std::string Grid::getStateString() const
 
 void Grid::setStateString(const std::string& state)
 {
-    size_t index = 0;
-
-    for (int y = 0; y < _height && index < state.length(); y++) {
-        for (int x = 0; x < _width && index < state.length(); x++) {
-            if (_enabled[y][x]) {
-                char pieceChar = state[index++];
+    size_t count = std::min(state.length(), _enabledIndices.size());
 
-                // Clear existing piece
-                _squares[y][x]->destroyBit();
+    for (size_t i = 0; i < count; i++) {
+        // Clear existing piece
+        _squares[_enabledIndices[i]].destroyBit();
 
-                // This method just sets the state - games need to create their own pieces
-                // when loading from state string based on the piece type
-            }
-        }
+        // This method just sets the state - games need to create their own pieces
+        // when loading from state string based on the piece type
     }
-}
\ No newline at end of file
+}
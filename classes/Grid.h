@@ -1,6 +1,8 @@
 #pragma once
 
 #include "ChessSquare.h"
+#include <concepts>
+#include <cstdint>
 #include <vector>
 #include <unordered_map>
 #include <functional>
@@ -18,6 +20,8 @@ public:
     bool isValid(int x, int y) const;
     bool isEnabled(int x, int y) const;
     void setEnabled(int x, int y, bool enabled);
+    // indices of the enabled squares in board order
+    const std::vector<int>& getEnabledIndices() const { return _enabledIndices; }
 
     // Grid properties
     int getWidth() const { return _width; }
@@ -25,6 +29,11 @@ public:
     int getIndex(int x, int y) const { return y * _width + x; }
     void getCoordinates(int index, int& x, int& y) const;
 
+    // hit testing, the enabled square under a point in window coordinates or nullptr.
+    // boards laid out by initializeSquares are a plain division, any other layout falls
+    // back to asking every enabled square
+    ChessSquare* squareAtPoint(const ImVec2& point);
+
     // Directional helpers (built into Grid)
     ChessSquare* getFL(int x, int y);  // front-left (up-left diagonal)
     ChessSquare* getFR(int x, int y);  // front-right (up-right diagonal)
@@ -50,9 +59,62 @@ public:
     bool areConnected(int fromX, int fromY, int toX, int toY);
 
     // Iterator support
+    // lambdas bind to the templates below and get inlined, the std::function versions stay
+    // for callers that already hold one
     void forEachSquare(std::function<void(ChessSquare*, int x, int y)> func);
     void forEachEnabledSquare(std::function<void(ChessSquare*, int x, int y)> func);
 
+    template <typename Func>
+        requires std::invocable<Func&, ChessSquare*, int, int>
+    void forEachSquare(Func&& func)
+    {
+        for (int index = 0; index < (int)_squares.size(); index++) {
+            func(&_squares[index], index % _width, index / _width);
+        }
+    }
+
+    template <typename Func>
+        requires std::invocable<Func&, ChessSquare*, int, int>
+    void forEachEnabledSquare(Func&& func)
+    {
+        for (int index : _enabledIndices) {
+            func(&_squares[index], index % _width, index / _width);
+        }
+    }
+
+    // early exit searches, stop at the first square the predicate accepts
+    template <typename Pred>
+        requires std::predicate<Pred&, ChessSquare*, int, int>
+    ChessSquare* findFirst(Pred&& pred)
+    {
+        for (int index = 0; index < (int)_squares.size(); index++) {
+            if (pred(&_squares[index], index % _width, index / _width)) {
+                return &_squares[index];
+            }
+        }
+        return nullptr;
+    }
+
+    template <typename Pred>
+        requires std::predicate<Pred&, ChessSquare*, int, int>
+    ChessSquare* findFirstEnabled(Pred&& pred)
+    {
+        for (int index : _enabledIndices) {
+            if (pred(&_squares[index], index % _width, index / _width)) {
+                return &_squares[index];
+            }
+        }
+        return nullptr;
+    }
+
+    template <typename Pred>
+        requires std::predicate<Pred&, ChessSquare*, int, int>
+    bool anyOf(Pred&& pred) { return findFirst(std::forward<Pred>(pred)) != nullptr; }
+
+    template <typename Pred>
+        requires std::predicate<Pred&, ChessSquare*, int, int>
+    bool anyEnabledOf(Pred&& pred) { return findFirstEnabled(std::forward<Pred>(pred)) != nullptr; }
+
     // Initialize squares with positions and sprites
     void initializeSquares(float squareSize, const char* spriteName);
     void initializeSquare(int x, int y, float squareSize, const char* spriteName);
@@ -62,9 +124,19 @@ public:
     void setStateString(const std::string& state);
 
 private:
-    std::vector<std::vector<ChessSquare*>> _squares;
-    std::vector<std::vector<bool>> _enabled;
+    bool isEnabledIndex(int index) const { return (_enabled[index >> 6] >> (index & 63)) & 1; }
+
+    // one contiguous block of squares in getIndex order, never resized after construction
+    // so the pointers handed out stay good for the life of the grid
+    std::vector<ChessSquare> _squares;
+    std::vector<uint64_t> _enabled;
+    std::vector<int> _enabledIndices;
     std::unordered_map<int, std::vector<int>> _connections;
     int _width;
     int _height;
+
+    // set by initializeSquares, squares placed one at a time clear it
+    bool _regularLayout = false;
+    float _squareSize = 0.0f;
+    ImVec2 _layoutOrigin;
 };
\ No newline at end of file
@@ -48,7 +48,7 @@ void Othello::setUpBoard() {
 }
 
 Bit* Othello::createPiece(Player* player) {
-    Bit* bit = new Bit();
+    Bit* bit = _bitPool.acquire();
     bit->LoadTextureFromFile(player == getPlayerAt(BLACK_PLAYER) ? "o.png" : "x.png");
     bit->setOwner(player);
     return bit;
@@ -63,6 +63,7 @@ bool Othello::actionForEmptyHolder(BitHolder &holder) {
     Player* currentPlayer = getCurrentPlayer();
 
     if (!isValidMove(x, y, currentPlayer)) return false;
+    uint32_t move = encodeMove(x, y, currentPlayer);
 
     // Place the piece
     Bit* newPiece = createPiece(currentPlayer);
@@ -79,16 +80,119 @@ bool Othello::actionForEmptyHolder(BitHolder &holder) {
         _consecutivePasses++;
         if (hasValidMove(currentPlayer)) {
             // Next player passes, current player continues
+            recordMove(move, true);
             return true;
         } else {
             _consecutivePasses = 2; // Game ends
         }
     }
 
+    recordMove(move);
     endTurn();
     return true;
 }
 
+//
+// history moves: the cell in the low 6 bits, then 3 bits per direction for how many
+// pieces flipped that way, and the player on bit 30
+//
+uint32_t Othello::encodeMove(int x, int y, Player* player) const {
+    uint32_t move = (uint32_t)(y * 8 + x);
+    for (int i = 0; i < 8; i++) {
+        uint32_t count = (uint32_t)checkDirection(x, y, DIRECTIONS[i][0], DIRECTIONS[i][1], player);
+        move |= count << (6 + 3 * i);
+    }
+    return move | ((uint32_t)player->playerNumber() << 30);
+}
+
+void Othello::applyMoveToSnapshot(BoardSnapshot &snapshot, uint32_t move) const {
+    if (snapshot.variant != kSnapshotVariant) return;
+    int x = move & 7;
+    int y = (move >> 3) & 7;
+    int player = (move >> 30) & 1;
+    snapshot.set(player, y * 8 + x);
+    for (int i = 0; i < 8; i++) {
+        int count = (move >> (6 + 3 * i)) & 7;
+        for (int step = 1; step <= count; step++) {
+            int cell = (y + DIRECTIONS[i][1] * step) * 8 + (x + DIRECTIONS[i][0] * step);
+            snapshot.set(player, cell);
+            snapshot.reset(1 - player, cell);
+        }
+    }
+    // after a pass the same player goes again
+    bool continues = (move & GameHistory::kTurnContinues) != 0;
+    snapshot.sideToMove = (uint8_t)(continues ? player : 1 - player);
+}
+
+BoardSnapshot Othello::snapshot() {
+    BoardSnapshot snapshot;
+    snapshot.variant = kSnapshotVariant;
+    snapshot.sideToMove = (uint8_t)getCurrentPlayer()->playerNumber();
+    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
+        Bit* bit = square->bit();
+        if (bit) {
+            snapshot.set(bit->getOwner() == getPlayerAt(BLACK_PLAYER) ? BLACK_PLAYER : WHITE_PLAYER, y * 8 + x);
+        }
+    });
+    return snapshot;
+}
+
+bool Othello::restoreSnapshot(const BoardSnapshot &snapshot) {
+    if (snapshot.variant != kSnapshotVariant) return false;
+    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
+        square->destroyBit();
+        for (int player = BLACK_PLAYER; player <= WHITE_PLAYER; player++) {
+            if (snapshot.test(player, y * 8 + x)) {
+                Bit* piece = createPiece(getPlayerAt(player));
+                piece->setPosition(square->getPosition());
+                square->setBit(piece);
+                break;
+            }
+        }
+    });
+    bool blocked = !hasValidMove(getPlayerAt(BLACK_PLAYER)) && !hasValidMove(getPlayerAt(WHITE_PLAYER));
+    _consecutivePasses = blocked ? 2 : 0;
+    return true;
+}
+
+//
+// history steps turn the flipped discs over in place instead of rebuilding them,
+// undo is the same walk handing them back to the opponent
+//
+void Othello::setFlippedOwner(uint32_t move, Player* player) {
+    int x = move & 7;
+    int y = (move >> 3) & 7;
+    for (int i = 0; i < 8; i++) {
+        int count = (move >> (6 + 3 * i)) & 7;
+        for (int step = 1; step <= count; step++) {
+            Bit* piece = _grid->getSquare(x + DIRECTIONS[i][0] * step, y + DIRECTIONS[i][1] * step)->bit();
+            if (piece) {
+                piece->LoadTextureFromFile(player == getPlayerAt(BLACK_PLAYER) ? "o.png" : "x.png");
+                piece->setOwner(player);
+            }
+        }
+    }
+}
+
+void Othello::applyMove(uint32_t move) {
+    Player* player = getPlayerAt((move >> 30) & 1);
+    ChessSquare* square = _grid->getSquare(move & 7, (move >> 3) & 7);
+    Bit* newPiece = createPiece(player);
+    newPiece->setPosition(square->getPosition());
+    square->setBit(newPiece);
+    setFlippedOwner(move, player);
+    // only the last move of a finished game can leave both sides without a move
+    bool blocked = !hasValidMove(getPlayerAt(BLACK_PLAYER)) && !hasValidMove(getPlayerAt(WHITE_PLAYER));
+    _consecutivePasses = blocked ? 2 : 0;
+}
+
+void Othello::unapplyMove(uint32_t move) {
+    Player* opponent = getPlayerAt(1 - ((move >> 30) & 1));
+    setFlippedOwner(move, opponent);
+    _grid->getSquare(move & 7, (move >> 3) & 7)->destroyBit();
+    _consecutivePasses = 0;
+}
+
 bool Othello::canBitMoveFrom(Bit &bit, BitHolder &src) {
     return false; // Pieces cannot be moved in Othello
 }
@@ -158,13 +262,9 @@ void Othello::flipInDirection(int x, int y, int dx, int dy, Player* player, int
 }
 
 bool Othello::hasValidMove(Player* player) const {
-    bool hasMove = false;
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        if (!hasMove && isValidMove(x, y, player)) {
-            hasMove = true;
-        }
+    return _grid->anyOf([&](ChessSquare* square, int x, int y) {
+        return isValidMove(x, y, player);
     });
-    return hasMove;
 }
 
 std::vector<std::pair<int, int>> Othello::getValidMoves(Player* player) const {
@@ -190,9 +290,8 @@ Player* Othello::checkForWinner() {
     }
 
     // Check if board is full
-    bool boardFull = true;
-    _grid->forEachSquare([&boardFull](ChessSquare* square, int x, int y) {
-        if (!square->bit()) boardFull = false;
+    bool boardFull = !_grid->anyOf([](ChessSquare* square, int x, int y) {
+        return !square->bit();
     });
 
     if (boardFull) {
@@ -213,9 +312,8 @@ bool Othello::checkForDraw() {
         return blackCount == whiteCount;
     }
 
-    bool boardFull = true;
-    _grid->forEachSquare([&boardFull](ChessSquare* square, int x, int y) {
-        if (!square->bit()) boardFull = false;
+    bool boardFull = !_grid->anyOf([](ChessSquare* square, int x, int y) {
+        return !square->bit();
     });
 
     if (boardFull) {
@@ -298,8 +396,13 @@ void Othello::setStateString(const std::string &s) {
 void Othello::updateAI() {
     if (!gameHasAI()) return;
 
+    auto start = std::chrono::steady_clock::now();
     Player* aiPlayer = getCurrentPlayer();
     std::vector<std::pair<int, int>> validMoves = getValidMoves(aiPlayer);
+    _aiStats = SearchStats();
+    _aiStats.nodes = validMoves.size();
+    _aiStats.depth = validMoves.empty() ? 0 : 1;
+    _aiStats.selDepth = _aiStats.depth;
 
     if (validMoves.empty()) {
         _consecutivePasses++;
@@ -322,6 +425,8 @@ void Othello::updateAI() {
         }
     }
 
+    _aiStats.timeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
     if (bestX >= 0 && bestY >= 0) {
         actionForEmptyHolder(*_grid->getSquare(bestX, bestY));
     }
@@ -22,17 +22,28 @@ public:
     bool        canBitMoveFrom(Bit &bit, BitHolder &src) override;
     bool        canBitMoveFromTo(Bit &bit, BitHolder &src, BitHolder &dst) override;
     void        stopGame() override;
+    BoardSnapshot snapshot() override;
+    bool        restoreSnapshot(const BoardSnapshot &snapshot) override;
+    void        applyMoveToSnapshot(BoardSnapshot &snapshot, uint32_t move) const override;
 
     // AI methods
     void        updateAI() override;
     bool        gameHasAI() override { return true; } // Set to true when AI is implemented
+    bool        aiSearchStats(SearchStats &stats) override { stats = _aiStats; return true; }
     Grid* getGrid() override { return _grid; }
 
+protected:
+    void        applyMove(uint32_t move) override;
+    void        unapplyMove(uint32_t move) override;
+
 private:
     // Player constants
     static const int BLACK_PLAYER = 0;
     static const int WHITE_PLAYER = 1;
 
+    // snapshots keep one plane of discs per player
+    static constexpr uint32_t kSnapshotVariant = BoardSnapshot::makeVariant('O', 8, 8);
+
     // Direction vectors for checking all 8 directions
     static const int DIRECTIONS[8][2];
 
@@ -41,7 +52,9 @@ private:
     bool        isValidMove(int x, int y, Player* player) const;
     int         checkDirection(int x, int y, int dx, int dy, Player* player) const;
     void        flipPieces(int x, int y, Player* player);
+    uint32_t    encodeMove(int x, int y, Player* player) const;
     void        flipInDirection(int x, int y, int dx, int dy, Player* player, int count);
+    void        setFlippedOwner(uint32_t move, Player* player);
     bool        hasValidMove(Player* player) const;
     void        countPieces(int &blackCount, int &whiteCount) const;
     std::vector<std::pair<int, int>> getValidMoves(Player* player) const;
@@ -57,4 +70,6 @@ private:
     // Game state
     int         _consecutivePasses;
     bool        _showingHints;
+    // the AI is a one ply look at every legal move, counted the same way as a search
+    SearchStats _aiStats;
 };
\ No newline at end of file
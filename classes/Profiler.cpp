@@ -0,0 +1,198 @@
+#include "Profiler.h"
+#include "imgui/imgui.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+
+// the scope whose per frame total is reported as the frame time
+static const char *kFrameScope = "RenderGame";
+
+Profiler &Profiler::instance()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Profiler()
+    : _epoch(Clock::now())
+{
+    _samples.resize(kMaxSamples);
+}
+
+uint32_t Profiler::threadIndex()
+{
+    // small stable numbers read better in the trace viewer than hashed thread ids
+    static std::atomic<uint32_t> nextIndex{0};
+    thread_local uint32_t index = nextIndex++;
+    return index;
+}
+
+//
+// names are nearly always the same literal, so the pointer compare hits first.
+// the same text from another translation unit can have its own address, strcmp catches that
+//
+Profiler::ScopeStats *Profiler::statsFor(const char *name)
+{
+    for (int i = 0; i < _scopeCount; i++) {
+        if (_scopes[i].name == name || std::strcmp(_scopes[i].name, name) == 0) {
+            return &_scopes[i];
+        }
+    }
+    if (_scopeCount == kMaxScopes) {
+        return nullptr;
+    }
+    ScopeStats &stats = _scopes[_scopeCount++];
+    stats.name = name;
+    return &stats;
+}
+
+void Profiler::record(const char *name, Clock::time_point start, Clock::time_point end)
+{
+    Sample sample;
+    sample.name = name;
+    sample.thread = threadIndex();
+    sample.startUs = std::chrono::duration_cast<std::chrono::microseconds>(start - _epoch).count();
+    sample.durationUs = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _samples[_nextSample] = sample;
+    if (++_nextSample == _samples.size()) {
+        _nextSample = 0;
+        _samplesWrapped = true;
+    }
+    ScopeStats *stats = statsFor(name);
+    if (stats) {
+        stats->frameTotalMs += std::chrono::duration<double, std::milli>(end - start).count();
+    }
+}
+
+void Profiler::beginFrame()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (int i = 0; i < _scopeCount; i++) {
+        _scopes[i].history[_frameIndex] = (float)_scopes[i].frameTotalMs;
+        _scopes[i].frameTotalMs = 0.0;
+    }
+    _frameIndex = (_frameIndex + 1) % kFrameHistory;
+    _framesRecorded = std::min(_framesRecorded + 1, kFrameHistory);
+}
+
+float Profiler::percentile(std::vector<float> &values, float percentile)
+{
+    if (values.empty()) {
+        return 0.0f;
+    }
+    size_t rank = std::min(values.size() - 1, (size_t)(percentile / 100.0f * values.size()));
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank];
+}
+
+float Profiler::framePercentile(float percentile) const
+{
+    std::vector<float> frames;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (int i = 0; i < _scopeCount; i++) {
+            if (std::strcmp(_scopes[i].name, kFrameScope) == 0) {
+                frames.assign(_scopes[i].history.begin(), _scopes[i].history.begin() + _framesRecorded);
+            }
+        }
+    }
+    return Profiler::percentile(frames, percentile);
+}
+
+void Profiler::drawWindow(bool *open)
+{
+    // copy what we show so the workers aren't held up while ImGui lays the window out
+    std::vector<ScopeStats> scopes;
+    int frameIndex;
+    int framesRecorded;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        scopes.assign(_scopes, _scopes + _scopeCount);
+        frameIndex = _frameIndex;
+        framesRecorded = _framesRecorded;
+    }
+
+    if (!ImGui::Begin("Profiler", open)) {
+        ImGui::End();
+        return;
+    }
+
+    const ScopeStats *frame = nullptr;
+    for (const ScopeStats &stats : scopes) {
+        if (std::strcmp(stats.name, kFrameScope) == 0) {
+            frame = &stats;
+        }
+    }
+    if (frame) {
+        std::vector<float> frames(frame->history.begin(), frame->history.begin() + framesRecorded);
+        float p50 = percentile(frames, 50.0f);
+        float p95 = percentile(frames, 95.0f);
+        float p99 = percentile(frames, 99.0f);
+        ImGui::Text("Frame (%s): p50 %.3f ms  p95 %.3f ms  p99 %.3f ms", kFrameScope, p50, p95, p99);
+        // oldest frame first, so the newest is always at the right edge
+        int offset = framesRecorded < kFrameHistory ? 0 : frameIndex;
+        ImGui::PlotHistogram("##frames", frame->history.data(), framesRecorded, offset, nullptr, 0.0f, std::max(p99 * 1.25f, 0.1f), ImVec2(-1, 80));
+    }
+    ImGui::Text("%.1f fps, %d frames kept", ImGui::GetIO().Framerate, framesRecorded);
+
+    if (ImGui::BeginTable("scopes", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV)) {
+        ImGui::TableSetupColumn("Scope");
+        ImGui::TableSetupColumn("Last ms");
+        ImGui::TableSetupColumn("p50 ms");
+        ImGui::TableSetupColumn("p95 ms");
+        ImGui::TableHeadersRow();
+        int last = (frameIndex + kFrameHistory - 1) % kFrameHistory;
+        for (const ScopeStats &stats : scopes) {
+            std::vector<float> frames(stats.history.begin(), stats.history.begin() + framesRecorded);
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(stats.name);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", stats.history[last]);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", percentile(frames, 50.0f));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", percentile(frames, 95.0f));
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::Button("Save Chrome Trace")) {
+        writeChromeTrace("profile.json");
+    }
+    ImGui::SameLine();
+    ImGui::TextDisabled("profile.json");
+    ImGui::End();
+}
+
+//
+// chrome's trace event format, every sample is a complete ("X") event on its thread
+//
+bool Profiler::writeChromeTrace(const std::string &path)
+{
+    std::vector<Sample> samples;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_samplesWrapped) {
+            samples.assign(_samples.begin() + _nextSample, _samples.end());
+        }
+        samples.insert(samples.end(), _samples.begin(), _samples.begin() + _nextSample);
+    }
+
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    file << "{\"traceEvents\":[\n";
+    for (size_t i = 0; i < samples.size(); i++) {
+        const Sample &sample = samples[i];
+        file << "{\"name\":\"" << sample.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << sample.thread
+             << ",\"ts\":" << sample.startUs << ",\"dur\":" << sample.durationUs << "}"
+             << (i + 1 < samples.size() ? ",\n" : "\n");
+    }
+    file << "],\"displayTimeUnit\":\"ms\"}\n";
+    return (bool)file;
+}
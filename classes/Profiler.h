@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//
+// scoped timers for finding out where a frame goes.
+// PROFILE_SCOPE("name") times the rest of the enclosing block, from any thread. samples go
+// into a ring buffer that the profiler window summarises each frame and that can be written
+// out as a chrome trace for chrome://tracing or ui.perfetto.dev.
+// the timers compile to nothing unless ENABLE_PROFILER is defined, debug builds turn it on
+//
+
+#if !defined(ENABLE_PROFILER) && !defined(NDEBUG)
+#define ENABLE_PROFILER
+#endif
+
+class Profiler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static const int kMaxSamples = 1 << 16;
+    static constexpr int kFrameHistory = 600;     // constexpr, std::min takes it by reference
+    static const int kMaxScopes = 32;
+
+    struct Sample
+    {
+        const char *    name;
+        uint32_t        thread;
+        int64_t         startUs;
+        int64_t         durationUs;
+    };
+
+    class Scope
+    {
+    public:
+        explicit Scope(const char *name) : _name(name), _start(Clock::now()) {}
+        ~Scope() { Profiler::instance().record(_name, _start, Clock::now()); }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        const char *        _name;
+        Clock::time_point   _start;
+    };
+
+    static Profiler &instance();
+
+    // close the previous frame's totals, called once at the top of every frame
+    void        beginFrame();
+    // name must be a string literal, only the pointer is kept
+    void        record(const char *name, Clock::time_point start, Clock::time_point end);
+
+    // percentile of the frame times in the history, in milliseconds
+    float       framePercentile(float percentile) const;
+
+    // the overlay window with frame time percentiles, the histogram and per scope times
+    void        drawWindow(bool *open);
+    bool        writeChromeTrace(const std::string &path);
+
+private:
+    Profiler();
+
+    struct ScopeStats
+    {
+        const char *    name = nullptr;
+        double          frameTotalMs = 0.0;
+        std::array<float, kFrameHistory> history{};
+    };
+
+    static uint32_t threadIndex();
+    static float    percentile(std::vector<float> &values, float percentile);
+    ScopeStats *    statsFor(const char *name);
+
+    mutable std::mutex  _mutex;
+    Clock::time_point   _epoch;
+    std::vector<Sample> _samples;
+    size_t              _nextSample = 0;
+    bool                _samplesWrapped = false;
+
+    ScopeStats          _scopes[kMaxScopes];
+    int                 _scopeCount = 0;
+    int                 _frameIndex = 0;
+    int                 _framesRecorded = 0;
+};
+
+#ifdef ENABLE_PROFILER
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) Profiler::Scope PROFILE_CONCAT(_profileScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#endif
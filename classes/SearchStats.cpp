@@ -0,0 +1,18 @@
+#include "SearchStats.h"
+#include "imgui/imgui.h"
+
+void SearchStats::draw() const
+{
+    if (!nodes) {
+        ImGui::TextDisabled("No search yet");
+        return;
+    }
+    ImGui::Text("Search: %s, %.1f ms", running ? "running" : "done", timeMs);
+    ImGui::Text("Nodes: %llu (%.0f kN/s)", (unsigned long long)nodes, nodesPerSecond() / 1000.0);
+    ImGui::Text("Depth: %d  Seldepth: %d", depth, selDepth);
+    if (usesTable) {
+        ImGui::Text("TT: %llu/%llu hits, %llu stores, %llu collisions", (unsigned long long)ttHits, (unsigned long long)ttProbes,
+                    (unsigned long long)ttStores, (unsigned long long)ttCollisions);
+    }
+    ImGui::Text("Beta cutoffs: %llu, %.1f%% on first move", (unsigned long long)betaCutoffs, firstMoveCutoffRate() * 100.0);
+}
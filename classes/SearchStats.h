@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+
+//
+// counters an AI search keeps while it runs, for tuning search features.
+// the searcher counts into its own copy with no locking and every so often publishes the
+// whole struct, the UI picks up the latest published copy once a frame from the render thread
+//
+
+struct SearchStats
+{
+    uint64_t    nodes = 0;
+    int         depth = 0;              // last iteration that finished
+    int         selDepth = 0;           // deepest ply reached, extensions included
+    uint64_t    ttProbes = 0;
+    uint64_t    ttHits = 0;             // probe found the same position
+    uint64_t    ttStores = 0;
+    uint64_t    ttCollisions = 0;       // store overwrote a different position
+    uint64_t    betaCutoffs = 0;
+    uint64_t    firstMoveCutoffs = 0;   // cutoffs on the first move tried, how good the ordering is
+    double      timeMs = 0.0;
+    bool        usesTable = false;      // searches without a transposition table skip the tt lines
+    bool        running = false;
+
+    double      nodesPerSecond() const { return timeMs > 0.0 ? nodes * 1000.0 / timeMs : 0.0; }
+    double      firstMoveCutoffRate() const { return betaCutoffs ? (double)firstMoveCutoffs / betaCutoffs : 0.0; }
+
+    // ImGui lines for a settings or status panel
+    void        draw() const;
+};
+
+//
+// hands whole SearchStats from the search thread to the render thread,
+// a reader never sees half of one publish and half of the next
+//
+class SearchStatsChannel
+{
+public:
+    void        publish(const SearchStats &stats)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stats = stats;
+    }
+    SearchStats latest() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _stats;
+    }
+
+private:
+    mutable std::mutex  _mutex;
+    SearchStats         _stats;
+};
@@ -1,30 +1,21 @@
 #include "Sprite.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
-#include <iostream>
-#include <filesystem>
+#include "TextureCache.h"
 
 // Simple helper function to load an image into a OpenGL texture with common settings
+// textures are shared through the cache, so only the first sprite to ask for an image pays for it
 bool Sprite::LoadTextureFromFile(const char* filename)
 {
-    // Load from file
-    int image_width = 0;
-    int image_height = 0;
-    std::filesystem::path resourcePath = std::filesystem::path("resources") / filename;
-    std::string newFilename = resourcePath.string();
-    unsigned char* image_data = stbi_load(newFilename.c_str(), &image_width, &image_height, NULL, 4);
-    if (image_data == NULL) {
+    CachedTexture cached;
+    if (!TextureCache::instance().getTexture(filename, cached)) {
         _size = ImVec2(0, 0);
-        std::cout << "Failed to load texture: " << newFilename << std::endl;
         return false;
     }
-    _texture = _loadTextureFromMemory(image_data, image_width, image_height);
-    stbi_image_free(image_data);
-    if (_texture == 0) {
-        _size = ImVec2(0, 0);
-        return false;
-    }
-    _size = ImVec2((float)image_width, (float)image_height);
+    _texture = cached.texture;
+    _uv0 = cached.uv0;
+    _uv1 = cached.uv1;
+    _size = ImVec2((float)cached.width, (float)cached.height);
     return true;
 }
 
@@ -60,6 +51,12 @@ ImTextureID Sprite::_loadTextureFromMemory(const unsigned char *image_data, int
     return static_cast<ImTextureID>(image_texture);
 }
 
+void Sprite::_freeTexture(ImTextureID texture)
+{
+    GLuint image_texture = (GLuint)(intptr_t)texture;
+    glDeleteTextures(1, &image_texture);
+}
+
 #else
 
 // DirectX
@@ -117,5 +114,13 @@ ImTextureID Sprite::_loadTextureFromMemory(const unsigned char *image_data, int
     }
     return reinterpret_cast<ImTextureID>(shaderResourceView);
 }
+
+void Sprite::_freeTexture(ImTextureID texture)
+{
+    ID3D11ShaderResourceView* shaderResourceView = reinterpret_cast<ID3D11ShaderResourceView*>(texture);
+    if (shaderResourceView) {
+        shaderResourceView->Release();
+    }
+}
 #endif
 
@@ -36,6 +36,7 @@ public:
         _location = ImVec2(point.x - _size.x / 2, point.y - _size.y / 2);
     }
     const ImVec2 &getPosition() { return _location; }
+    const ImVec2 &getSize() { return _size; }
 
     void setSize(float x, float y)
     {
@@ -66,8 +67,25 @@ public:
         {
             ImGui::SetCursorPos(_location);
             ImVec4 highlight = _highlighted ? ImVec4(1, 1, 0, 1) : ImVec4(0, 0, 0, 0);
-            ImGui::Image((void*)(intptr_t)_texture, _size, ImVec2(0, 0), ImVec2(1, 1), _color, highlight);
+            ImGui::Image((void*)(intptr_t)_texture, _size, _uv0, _uv1, _color, highlight);
         }
+    }
+    // batched drawing straight into a draw list, origin is the window's content origin in screen space.
+    // primSprite only adds the quad, the caller pushes this sprite's texture first
+    ImTextureID getTexture() const { return _texture; }
+    bool isDrawable() const { return _size.x > 0.0f && _size.y > 0.0f; }
+    void primSprite(ImDrawList *drawList, const ImVec2 &origin)
+    {
+        // a highlighted sprite is inset by the width of its frame, as ImGui::Image draws it
+        float inset = _highlighted ? 1.0f : 0.0f;
+        ImVec2 min(origin.x + _location.x + inset, origin.y + _location.y + inset);
+        drawList->PrimReserve(6, 4);
+        drawList->PrimRectUV(min, ImVec2(min.x + _size.x, min.y + _size.y), _uv0, _uv1, ImGui::GetColorU32(_color));
+    }
+    void paintHighlight(ImDrawList *drawList, const ImVec2 &origin)
+    {
+        ImVec2 min(origin.x + _location.x, origin.y + _location.y);
+        drawList->AddRect(min, ImVec2(min.x + _size.x + 2.0f, min.y + _size.y + 2.0f), ImGui::GetColorU32(ImVec4(1, 1, 0, 1)));
     }
 	// is the mouse over this position?
 	bool isMouseOver(const ImVec2 &mousePos)
@@ -100,10 +118,14 @@ protected:
     ImVec4  _color;
     // the local Z order
     int _localZOrder;
-    // the texture we're going to draw
+    // the texture we're going to draw, and the part of it that is ours when it's the atlas
     ImTextureID _texture;
+    ImVec2 _uv0 = ImVec2(0, 0);
+    ImVec2 _uv1 = ImVec2(1, 1);
     // currently highlighted
    	bool	_highlighted;
-    // private platform specific texture loading
-    ImTextureID _loadTextureFromMemory(const unsigned char *image_data, int image_width, int image_height);
+    // private platform specific texture loading, shared with the texture cache
+    static ImTextureID _loadTextureFromMemory(const unsigned char *image_data, int image_width, int image_height);
+    static void _freeTexture(ImTextureID texture);
+    friend class TextureCache;
 };
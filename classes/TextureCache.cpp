@@ -0,0 +1,299 @@
+#include "TextureCache.h"
+#include "Sprite.h"
+#include "stb_image.h"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+// imgui compiles its copy of the rect packer static, so this file gets its own
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "../imgui/imstb_rectpack.h"
+
+TextureCache &TextureCache::instance()
+{
+    static TextureCache cache;
+    return cache;
+}
+
+TextureCache::~TextureCache()
+{
+    joinWorkers();
+    for (auto &it : _entries) {
+        if (it.second->pixels) {
+            stbi_image_free(it.second->pixels);
+        }
+    }
+}
+
+//
+// collect every png in resources/ and hand them to the worker threads
+//
+void TextureCache::startPreload(unsigned int threadCount)
+{
+    if (!_jobs.empty()) {
+        return;
+    }
+
+    std::error_code error;
+    std::filesystem::directory_iterator dir("resources", error);
+    if (error) {
+        std::cout << "Texture preload: no resources directory" << std::endl;
+        return;
+    }
+    for (const auto &file : dir) {
+        if (file.is_regular_file() && file.path().extension() == ".png") {
+            Entry *entry = findOrAddEntry(file.path().filename().string());
+            entry->isJob = true;
+            _jobs.push_back(entry);
+        }
+    }
+    if (_jobs.empty()) {
+        return;
+    }
+
+    if (threadCount == 0) {
+        // leave a core for the render thread
+        unsigned int cores = std::thread::hardware_concurrency();
+        threadCount = cores > 1 ? cores - 1 : 1;
+    }
+    threadCount = std::min<unsigned int>(threadCount, (unsigned int)_jobs.size());
+    for (unsigned int i = 0; i < threadCount; i++) {
+        _workers.emplace_back(&TextureCache::workerLoop, this);
+    }
+}
+
+void TextureCache::workerLoop()
+{
+    for (;;) {
+        size_t index = _nextJob.fetch_add(1);
+        if (index >= _jobs.size()) {
+            return;
+        }
+        Entry &entry = *_jobs[index];
+        int expected = kPending;
+        // the render thread may have claimed it already because a sprite needed it right away
+        if (entry.state.compare_exchange_strong(expected, kDecoding)) {
+            decodeEntry(entry);
+        }
+    }
+}
+
+void TextureCache::joinWorkers()
+{
+    for (auto &worker : _workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    _workers.clear();
+}
+
+//
+// decode on whatever thread claimed the entry, publishing the result through the state
+//
+void TextureCache::decodeEntry(Entry &entry)
+{
+    std::filesystem::path resourcePath = std::filesystem::path("resources") / entry.name;
+    entry.pixels = stbi_load(resourcePath.string().c_str(), &entry.width, &entry.height, NULL, 4);
+    if (entry.pixels == NULL) {
+        std::cout << "Failed to load texture: " << resourcePath.string() << std::endl;
+        entry.state.store(kFailed, std::memory_order_release);
+        return;
+    }
+    entry.state.store(kDecoded, std::memory_order_release);
+}
+
+bool TextureCache::uploadEntry(Entry &entry)
+{
+    entry.texture.texture = Sprite::_loadTextureFromMemory(entry.pixels, entry.width, entry.height);
+    stbi_image_free(entry.pixels);
+    entry.pixels = nullptr;
+    if (entry.texture.texture == 0) {
+        entry.state.store(kFailed, std::memory_order_relaxed);
+        finishEntry(entry);
+        return false;
+    }
+    entry.texture.width = entry.width;
+    entry.texture.height = entry.height;
+    entry.state.store(kUploaded, std::memory_order_relaxed);
+    finishEntry(entry);
+    return true;
+}
+
+void TextureCache::finishEntry(Entry &entry)
+{
+    if (entry.isJob && !entry.counted) {
+        entry.counted = true;
+        _uploadedCount++;
+    }
+}
+
+ImTextureID TextureCache::createTexture(const unsigned char *rgba, int width, int height)
+{
+    return Sprite::_loadTextureFromMemory(rgba, width, height);
+}
+
+void TextureCache::destroyTexture(ImTextureID texture)
+{
+    if (texture) {
+        Sprite::_freeTexture(texture);
+    }
+}
+
+bool TextureCache::allJobsDecoded() const
+{
+    for (const Entry *entry : _jobs) {
+        int state = entry->state.load(std::memory_order_acquire);
+        if (state == kPending || state == kDecoding) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//
+// pack every decoded image into the smallest square that holds them all, copy the pixels
+// across with their edges extended into the padding, and upload the lot as one texture
+//
+void TextureCache::buildAtlas()
+{
+    _atlasBuilt = true;
+    std::vector<Entry *> images;
+    std::vector<stbrp_rect> rects;
+    for (const auto &it : _entries) {
+        Entry *entry = it.second.get();
+        if (entry->state.load(std::memory_order_acquire) == kDecoded) {
+            stbrp_rect rect = {};
+            rect.id = (int)images.size();
+            rect.w = entry->width + kAtlasPadding * 2;
+            rect.h = entry->height + kAtlasPadding * 2;
+            rects.push_back(rect);
+            images.push_back(entry);
+        }
+    }
+    if (images.empty()) {
+        return;
+    }
+
+    int size = 256;
+    std::vector<stbrp_node> nodes;
+    for (;; size *= 2) {
+        nodes.resize(size);
+        stbrp_context context;
+        stbrp_init_target(&context, size, size, nodes.data(), (int)nodes.size());
+        if (stbrp_pack_rects(&context, rects.data(), (int)rects.size()) || size >= kMaxAtlasSize) {
+            break;
+        }
+        for (stbrp_rect &rect : rects) {
+            rect.was_packed = 0;
+        }
+    }
+
+    std::vector<unsigned char> pixels((size_t)size * size * 4, 0);
+    for (const stbrp_rect &rect : rects) {
+        if (!rect.was_packed) {
+            continue;
+        }
+        const Entry &entry = *images[rect.id];
+        for (int y = 0; y < rect.h; y++) {
+            int sourceY = std::clamp(y - kAtlasPadding, 0, entry.height - 1);
+            for (int x = 0; x < rect.w; x++) {
+                int sourceX = std::clamp(x - kAtlasPadding, 0, entry.width - 1);
+                const unsigned char *source = entry.pixels + ((size_t)sourceY * entry.width + sourceX) * 4;
+                std::copy(source, source + 4, &pixels[((size_t)(rect.y + y) * size + rect.x + x) * 4]);
+            }
+        }
+    }
+    ImTextureID atlas = Sprite::_loadTextureFromMemory(pixels.data(), size, size);
+    if (atlas == 0) {
+        // leave them all to be uploaded on their own
+        return;
+    }
+    _atlasSize = size;
+
+    for (const stbrp_rect &rect : rects) {
+        if (!rect.was_packed) {
+            continue;
+        }
+        Entry &entry = *images[rect.id];
+        entry.texture.texture = atlas;
+        entry.texture.width = entry.width;
+        entry.texture.height = entry.height;
+        entry.texture.uv0 = ImVec2((float)(rect.x + kAtlasPadding) / size, (float)(rect.y + kAtlasPadding) / size);
+        entry.texture.uv1 = ImVec2((float)(rect.x + kAtlasPadding + entry.width) / size, (float)(rect.y + kAtlasPadding + entry.height) / size);
+        stbi_image_free(entry.pixels);
+        entry.pixels = nullptr;
+        entry.state.store(kUploaded, std::memory_order_relaxed);
+        finishEntry(entry);
+    }
+}
+
+void TextureCache::uploadPending(int maxUploads)
+{
+    if (preloadFinished()) {
+        joinWorkers();
+        return;
+    }
+    if (!_atlasBuilt) {
+        if (!allJobsDecoded()) {
+            return;
+        }
+        buildAtlas();
+    }
+    int uploads = 0;
+    for (size_t i = _nextUpload; i < _jobs.size() && uploads < maxUploads; i++) {
+        Entry &entry = *_jobs[i];
+        int state = entry.state.load(std::memory_order_acquire);
+        if (state == kDecoded) {
+            uploadEntry(entry);
+            uploads++;
+        } else if (state == kFailed) {
+            finishEntry(entry);
+        }
+    }
+    // skip past the finished prefix so later frames don't rescan it
+    while (_nextUpload < _jobs.size() && _jobs[_nextUpload]->counted) {
+        _nextUpload++;
+    }
+}
+
+TextureCache::Entry *TextureCache::findOrAddEntry(const std::string &name)
+{
+    auto it = _entries.find(name);
+    if (it != _entries.end()) {
+        return it->second.get();
+    }
+    auto entry = std::make_unique<Entry>();
+    entry->name = name;
+    Entry *result = entry.get();
+    _entries.emplace(name, std::move(entry));
+    return result;
+}
+
+bool TextureCache::getTexture(const char *filename, CachedTexture &out)
+{
+    Entry &entry = *findOrAddEntry(filename);
+
+    int expected = kPending;
+    if (entry.state.compare_exchange_strong(expected, kDecoding)) {
+        // nobody has started on this one, so decode it here
+        decodeEntry(entry);
+    }
+    int state = entry.state.load(std::memory_order_acquire);
+    while (state == kDecoding) {
+        // a worker is part way through this image, it won't be long
+        std::this_thread::yield();
+        state = entry.state.load(std::memory_order_acquire);
+    }
+    if (state == kDecoded) {
+        uploadEntry(entry);
+        state = entry.state.load(std::memory_order_relaxed);
+    }
+    if (state != kUploaded) {
+        finishEntry(entry);
+        return false;
+    }
+    out = entry.texture;
+    return true;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "../imgui/imgui.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+//
+// shared cache of every texture loaded from resources/
+// at startup all pngs are decoded in parallel on worker threads. once every one is decoded
+// the render thread packs them into a single atlas texture and uploads it in one go, so a
+// board full of different pieces draws from one texture. every Sprite that asks for an image
+// shares the same GPU texture and reads its own rectangle of it through the uvs.
+// an image needed before the preload is done is uploaded on its own straight away.
+//
+
+struct CachedTexture
+{
+    ImTextureID texture = 0;
+    int         width = 0;
+    int         height = 0;
+    ImVec2      uv0 = ImVec2(0, 0);
+    ImVec2      uv1 = ImVec2(1, 1);
+};
+
+class TextureCache
+{
+public:
+    static TextureCache &instance();
+
+    // start decoding every png in resources/ on a small thread pool
+    void        startPreload(unsigned int threadCount = 0);
+    // build and upload the atlas once every image is decoded, render thread only.
+    // images the atlas can't hold are uploaded on their own, at most maxUploads per call
+    void        uploadPending(int maxUploads);
+
+    // progress of the startup preload
+    int         totalCount() const { return (int)_jobs.size(); }
+    int         uploadedCount() const { return _uploadedCount; }
+    bool        preloadFinished() const { return _uploadedCount >= (int)_jobs.size(); }
+    float       progress() const { return _jobs.empty() ? 1.0f : (float)_uploadedCount / (float)_jobs.size(); }
+
+    // textures a game draws itself rather than loading from resources/, render thread only.
+    // the cache doesn't keep these, whoever creates one destroys it
+    ImTextureID createTexture(const unsigned char *rgba, int width, int height);
+    void        destroyTexture(ImTextureID texture);
+
+    // atlas size in pixels, 0 until it has been built
+    int         atlasSize() const { return _atlasSize; }
+
+    // fetch a texture by resource file name, decoding and uploading it right away if the
+    // preloader has not gotten to it yet. render thread only.
+    bool        getTexture(const char *filename, CachedTexture &out);
+
+private:
+    TextureCache() = default;
+    ~TextureCache();
+
+    enum EntryState
+    {
+        kPending,
+        kDecoding,
+        kDecoded,
+        kUploaded,
+        kFailed
+    };
+
+    struct Entry
+    {
+        std::string             name;
+        std::atomic<int>        state{kPending};
+        unsigned char           *pixels = nullptr;
+        int                     width = 0;
+        int                     height = 0;
+        CachedTexture           texture;
+        bool                    isJob = false;
+        bool                    counted = false;
+    };
+
+    Entry       *findOrAddEntry(const std::string &name);
+    static void decodeEntry(Entry &entry);
+    bool        uploadEntry(Entry &entry);
+    void        finishEntry(Entry &entry);
+    bool        allJobsDecoded() const;
+    void        buildAtlas();
+    void        workerLoop();
+    void        joinWorkers();
+
+    std::unordered_map<std::string, std::unique_ptr<Entry>> _entries;
+    // the startup job list is fixed before the workers start, so they can walk it without locking
+    std::vector<Entry *>        _jobs;
+    std::atomic<size_t>         _nextJob{0};
+    std::vector<std::thread>    _workers;
+    size_t                      _nextUpload = 0;
+    int                         _uploadedCount = 0;
+    bool                        _atlasBuilt = false;
+    int                         _atlasSize = 0;
+
+    // empty pixels around each image in the atlas, filled from its edges so filtering
+    // never picks up a neighbour
+    static const int kAtlasPadding = 2;
+    static const int kMaxAtlasSize = 4096;
+};
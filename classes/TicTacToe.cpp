@@ -1,13 +1,21 @@
 #include "TicTacToe.h"
+#include <algorithm>
 
 
-TicTacToe::TicTacToe()
+TicTacToe::TicTacToe(int width, int height, int inARow) : _board(width, height, inARow)
 {
-    _grid = new Grid(3, 3);
+    // the board clamps the shape to what its bitboards can hold
+    _width = _board.width();
+    _height = _board.height();
+    _inARow = _board.inARow();
+    // keep big boards inside the game window
+    _squareSize = std::max(_width, _height) <= 8 ? 80.0f : std::max(32.0f, 640.0f / std::max(_width, _height));
+    _grid = new Grid(_width, _height);
 }
 
 TicTacToe::~TicTacToe()
 {
+    cancelAISearch();
     delete _grid;
 }
 
@@ -17,19 +25,21 @@ TicTacToe::~TicTacToe()
 Bit* TicTacToe::PieceForPlayer(const int playerNumber)
 {
     // depending on playerNumber load the "x.png" or the "o.png" graphic
-    Bit *bit = new Bit();
+    Bit *bit = _bitPool.acquire();
     // should possibly be cached from player class?
     bit->LoadTextureFromFile(playerNumber == AI_PLAYER ? "o.png" : "x.png");
     bit->setOwner(getPlayerAt(playerNumber == AI_PLAYER ? 1 : 0));
+    bit->setSize(_squareSize, _squareSize);
     return bit;
 }
 
 void TicTacToe::setUpBoard()
 {
     setNumberOfPlayers(2);
-    _gameOptions.rowX = 3;
-    _gameOptions.rowY = 3;
-    _grid->initializeSquares(80, "square.png");
+    _gameOptions.rowX = _width;
+    _gameOptions.rowY = _height;
+    _grid->initializeSquares(_squareSize, "square.png");
+    _board.clear();
 
     if (gameHasAI()) {
         setAIPlayer(AI_PLAYER);
@@ -43,13 +53,17 @@ void TicTacToe::setUpBoard()
 //
 bool TicTacToe::actionForEmptyHolder(BitHolder &holder)
 {
-    if (holder.bit()) {
+    if (holder.bit() || _board.winner() >= 0) {
         return false;
     }
     Bit *bit = PieceForPlayer(getCurrentPlayer()->playerNumber() == 0 ? HUMAN_PLAYER : AI_PLAYER);
     if (bit) {
         bit->setPosition(holder.getPosition());
         holder.setBit(bit);
+        ChessSquare &square = static_cast<ChessSquare &>(holder);
+        int cell = square.getRow() * _width + square.getColumn();
+        _board.play(cell);
+        recordMove(encodeMove(cell, getCurrentPlayer()->playerNumber()));
         endTurn();
         return true;
     }   
@@ -73,9 +87,11 @@ bool TicTacToe::canBitMoveFromTo(Bit &bit, BitHolder &src, BitHolder &dst)
 //
 void TicTacToe::stopGame()
 {
+    cancelAISearch();
     _grid->forEachSquare([](ChessSquare* square, int x, int y) {
         square->destroyBit();
     });
+    _board.clear();
 }
 
 //
@@ -83,7 +99,7 @@ void TicTacToe::stopGame()
 //
 Player* TicTacToe::ownerAt(int index ) const
 {
-    auto square = _grid->getSquare(index % 3, index / 3);
+    auto square = _grid->getSquare(index % _width, index / _width);
     if (!square || !square->bit()) {
         return nullptr;
     }
@@ -92,28 +108,101 @@ Player* TicTacToe::ownerAt(int index ) const
 
 Player* TicTacToe::checkForWinner()
 {
-    static const int kWinningTriples[8][3] =  { {0,1,2}, {3,4,5}, {6,7,8},  // rows
-                                                {0,3,6}, {1,4,7}, {2,5,8},  // cols
-                                                {0,4,8}, {2,4,6} };         // diagonals
-    for( int i=0; i<8; i++ ) {
-        const int *triple = kWinningTriples[i];
-        Player *player = ownerAt(triple[0]);
-        if( player && player == ownerAt(triple[1]) && player == ownerAt(triple[2]) )
-            return player;
-    }
-    return nullptr;
+    int winner = _board.winner();
+    return winner >= 0 ? getPlayerAt(winner) : nullptr;
 }
 
 bool TicTacToe::checkForDraw()
 {
-    bool isDraw = true;
-    // check to see if the board is full
-    _grid->forEachSquare([&isDraw](ChessSquare* square, int x, int y) {
-        if (!square->bit()) {
-            isDraw = false;
+    // a full board is only a draw when the last stone didn't win
+    return _board.full() && _board.winner() < 0;
+}
+
+//
+// history moves are the cell number with the player above it
+//
+uint32_t TicTacToe::encodeMove(int cell, int playerNumber)
+{
+    return (uint32_t)cell | ((uint32_t)playerNumber << 8);
+}
+
+void TicTacToe::applyMoveToSnapshot(BoardSnapshot &snapshot, uint32_t move) const
+{
+    int player = (move >> 8) & 1;
+    snapshot.set(player * kPlanesPerPlayer, move & 0xFF);
+    snapshot.sideToMove = (uint8_t)(1 - player);
+}
+
+//
+// snapshots hold each player's stones in four planes, enough for a 16 x 16 board
+//
+BoardSnapshot TicTacToe::snapshot()
+{
+    BoardSnapshot snapshot;
+    snapshot.variant = snapshotVariant();
+    snapshot.sideToMove = (uint8_t)_board.sideToMove();
+    for (int cell = 0; cell < _board.cellCount(); cell++) {
+        int owner = _board.ownerAt(cell);
+        if (owner >= 0) {
+            snapshot.set(owner * kPlanesPerPlayer, cell);
         }
+    }
+    return snapshot;
+}
+
+bool TicTacToe::restoreSnapshot(const BoardSnapshot &snapshot)
+{
+    if (snapshot.variant != snapshotVariant()) {
+        return false;
+    }
+    cancelAISearch();
+    TicTacToeBoard::Bitboard stones[2];
+    for (int cell = 0; cell < _board.cellCount(); cell++) {
+        for (int player = 0; player < 2; player++) {
+            if (snapshot.test(player * kPlanesPerPlayer, cell)) {
+                stones[player].set(cell);
+            }
+        }
+    }
+    _board = TicTacToeBoard::fromStones(stones[0], stones[1], _width, _height, _inARow);
+    syncGridFromBoard();
+    return true;
+}
+
+void TicTacToe::syncGridFromBoard()
+{
+    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
+        int owner = _board.ownerAt(y * _width + x);
+        if (owner < 0) {
+            square->destroyBit();
+            return;
+        }
+        Bit *bit = PieceForPlayer(owner == 1 ? AI_PLAYER : HUMAN_PLAYER);
+        bit->setPosition(square->getPosition());
+        square->setBit(bit);
     });
-    return isDraw;
+}
+
+//
+// history steps place or lift a single stone, the grid and the bitboards stay in step
+//
+void TicTacToe::applyMove(uint32_t move)
+{
+    cancelAISearch();
+    int cell = move & 0xFF;
+    ChessSquare *square = _grid->getSquare(cell % _width, cell / _width);
+    Bit *bit = PieceForPlayer(((move >> 8) & 1) ? AI_PLAYER : HUMAN_PLAYER);
+    bit->setPosition(square->getPosition());
+    square->setBit(bit);
+    _board.play(cell);
+}
+
+void TicTacToe::unapplyMove(uint32_t move)
+{
+    cancelAISearch();
+    int cell = move & 0xFF;
+    _grid->getSquare(cell % _width, cell / _width)->destroyBit();
+    _board.undo(cell);
 }
 
 //
@@ -121,7 +210,7 @@ bool TicTacToe::checkForDraw()
 //
 std::string TicTacToe::initialStateString()
 {
-    return "000000000";
+    return std::string(_width * _height, '0');
 }
 
 //
@@ -130,11 +219,11 @@ std::string TicTacToe::initialStateString()
 //
 std::string TicTacToe::stateString()
 {
-    std::string s = "000000000";
+    std::string s = initialStateString();
     _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
         Bit *bit = square->bit();
         if (bit) {
-            s[y * 3 + x] = std::to_string(bit->getOwner()->playerNumber()+1)[0];
+            s[y * _width + x] = std::to_string(bit->getOwner()->playerNumber()+1)[0];
         }
     });
     return s;
@@ -147,101 +236,170 @@ std::string TicTacToe::stateString()
 void TicTacToe::setStateString(const std::string &s)
 {
     _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        int index = y*3 + x;
-        int playerNumber = s[index] - '0';
+        int index = y*_width + x;
+        int playerNumber = index < (int)s.length() ? s[index] - '0' : 0;
         if (playerNumber) {
             square->setBit( PieceForPlayer(playerNumber-1) );
         } else {
             square->setBit( nullptr );
         }
     });
+    _board = TicTacToeBoard::fromStateString(s, _width, _height, _inARow);
 }
 
 
 //
-// this is the function that will be called by the AI
+// encode the board in base 3 from the point of view of the player to move:
+// 0 empty, 1 their own piece, 2 the opponent's
 //
-void TicTacToe::updateAI() 
+int TicTacToe::encodeBoard(int playerToMove) const
 {
-    int bestVal = -1000;
-    BitHolder* bestMove = nullptr;
-    std::string state = stateString();
+    int index = 0;
+    for (int cell = 8; cell >= 0; cell--) {
+        Player *owner = ownerAt(cell);
+        int digit = owner ? (owner->playerNumber() == playerToMove ? 1 : 2) : 0;
+        index = index * 3 + digit;
+    }
+    return index;
+}
 
-    // Traverse all cells, evaluate minimax function for all empty cells
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        int index = y * 3 + x;
-        // Check if cell is empty
-        if (state[index] == '0') {
-            // Make the move
-            state[index] = '2';
-            int moveVal = -negamax(state, 0, HUMAN_PLAYER);
-            // Undo the move
-            state[index] = '0';
-            // If the value of the current move is more than the best value, update best
-            if (moveVal > bestVal) {
-                bestMove = square;
-                bestVal = moveVal;
-            }
-        }
-    });
+namespace {
+
+const int kPositions = 19683;      // 3^9
+const int kPowersOf3[9] = {1, 3, 9, 27, 81, 243, 729, 2187, 6561};
+const int kWinScore = 10;
+
+//
+// perfect play for every encoded position, solved once on first use.
+// scores are for the player to move, a win in fewer moves scores higher.
+//
+struct PerfectPlayTable
+{
+    int8_t score[kPositions];
+    int8_t bestMove[kPositions];
+    bool   solved[kPositions] = {};
+
+    PerfectPlayTable()
+    {
+        std::fill(std::begin(bestMove), std::end(bestMove), (int8_t)-1);
+        solve(0);
+    }
 
+    static int digitAt(int index, int cell)
+    {
+        return (index / kPowersOf3[cell]) % 3;
+    }
 
-    // Make the best move
-    if(bestMove) {
-        if (actionForEmptyHolder(*bestMove)) {
+    // the same board seen by the other player
+    static int swapSides(int index)
+    {
+        int swapped = 0;
+        for (int cell = 0; cell < 9; cell++) {
+            int digit = digitAt(index, cell);
+            swapped += (digit ? 3 - digit : 0) * kPowersOf3[cell];
         }
+        return swapped;
     }
-}
 
-bool isAIBoardFull(const std::string& state) {
-    return state.find('0') == std::string::npos;
-}
+    static bool opponentHasLine(int index)
+    {
+        static const int kWinningTriples[8][3] =  { {0,1,2}, {3,4,5}, {6,7,8},  // rows
+                                                    {0,3,6}, {1,4,7}, {2,5,8},  // cols
+                                                    {0,4,8}, {2,4,6} };         // diagonals
+        for (const auto &triple : kWinningTriples) {
+            if (digitAt(index, triple[0]) == 2 && digitAt(index, triple[1]) == 2 && digitAt(index, triple[2]) == 2) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int solve(int index)
+    {
+        if (solved[index]) {
+            return score[index];
+        }
+        solved[index] = true;
+        bestMove[index] = -1;
+
+        // the player who just moved made a line
+        if (opponentHasLine(index)) {
+            return score[index] = -kWinScore;
+        }
 
-int evaluateAIBoard(const std::string& state) {
-    static const int kWinningTriples[8][3] =  { {0,1,2}, {3,4,5}, {6,7,8},  // rows
-                                                {0,3,6}, {1,4,7}, {2,5,8},  // cols
-                                                {0,4,8}, {2,4,6} };         // diagonals
-    for( int i=0; i<8; i++ ) {
-        const int *triple = kWinningTriples[i];
-        char first = state[triple[0]];
-        if( first != '0' && first == state[triple[1]] && first == state[triple[2]] ) {
-            return 10;   // someone won, negamax will handle who
+        int best = -kWinScore - 1;
+        for (int cell = 0; cell < 9; cell++) {
+            if (digitAt(index, cell) != 0) {
+                continue;
+            }
+            int value = -solve(swapSides(index + kPowersOf3[cell]));
+            // prefer quick wins and slow losses
+            if (value > 0) value--;
+            else if (value < 0) value++;
+            if (value > best) {
+                best = value;
+                bestMove[index] = (int8_t)cell;
+            }
         }
+        // a full board is a draw
+        return score[index] = (int8_t)(bestMove[index] < 0 ? 0 : best);
     }
-    return 0; // No winner
+};
+
+const PerfectPlayTable &perfectPlay()
+{
+    static const PerfectPlayTable table;
+    return table;
 }
 
+} // namespace
+
 //
-// player is the current player's number (AI or human)
+// this is the function that will be called by the AI
+// the classic board is a single table lookup, bigger ones search on a worker thread
+// the same way checkers does, and we check each frame whether it has an answer
 //
-int TicTacToe::negamax(std::string& state, int depth, int playerColor) 
+void TicTacToe::updateAI() 
 {
-    int score = evaluateAIBoard(state);
-
-    // Check if AI wins, human wins, or draw
-    if(score) { 
-        // A winning state is a loss for the player whose turn it is.
-        // The previous player made the winning move.
-        return -score; 
+    if (isClassicBoard()) {
+        int move = perfectPlay().bestMove[encodeBoard(getCurrentPlayer()->playerNumber())];
+        if (move < 0) {
+            return;
+        }
+        ChessSquare *square = _grid->getSquare(move % 3, move / 3);
+        if (square) {
+            actionForEmptyHolder(*square);
+        }
+        return;
     }
 
-    if(isAIBoardFull(state)) {
-        return 0; // Draw
+    if (_aiSearch.valid()) {
+        if (_aiSearch.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return;
+        }
+        TicTacToeAI::Result result = _aiSearch.get();
+        ChessSquare *square = result.found ? _grid->getSquare(result.cell % _width, result.cell / _width) : nullptr;
+        if (square) {
+            actionForEmptyHolder(*square);
+        }
+        return;
     }
 
-    int bestVal = -1000; // Min value
-    for (int y = 0; y < 3; y++) {
-        for (int x = 0; x < 3; x++) {
-            // Check if cell is empty
-            if (state[y * 3 + x] == '0') {
-                // Make the move
-                state[y * 3 + x] = playerColor == HUMAN_PLAYER ? '1' : '2'; // Set the cell to the current player's color
-                bestVal = std::max(bestVal, -negamax(state, depth + 1, -playerColor));
-                // Undo the move for backtracking
-                state[y * 3 + x] = '0';
-            }
-        }
+    if (_board.winner() >= 0 || _board.full()) {
+        return;
     }
+    TicTacToeBoard board = _board;
+    _ai.clearStop();
+    _aiSearch = std::async(std::launch::async, [this, board]() {
+        return _ai.search(board, kAIMaxDepth, kAITimeLimitMs);
+    });
+}
 
-    return bestVal;
-}
\ No newline at end of file
+void TicTacToe::cancelAISearch()
+{
+    if (_aiSearch.valid()) {
+        _ai.stop();
+        _aiSearch.wait();
+        _aiSearch = {};
+    }
+}
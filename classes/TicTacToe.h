@@ -1,8 +1,10 @@
 #pragma once
 #include "Game.h"
+#include "TicTacToeBoard.h"
+#include "TicTacToeAI.h"
 
 //
-// the classic game of tic tac toe
+// the classic game of tic tac toe, and its bigger m x n k in a row cousins like gomoku
 //
 
 //
@@ -11,7 +13,7 @@
 class TicTacToe : public Game
 {
 public:
-    TicTacToe();
+    TicTacToe(int width = 3, int height = 3, int inARow = 3);
     ~TicTacToe();
 
     // set up the board
@@ -26,15 +28,43 @@ public:
     bool        canBitMoveFrom(Bit &bit, BitHolder &src) override;
     bool        canBitMoveFromTo(Bit &bit, BitHolder &src, BitHolder &dst) override;
     void        stopGame() override;
+    BoardSnapshot snapshot() override;
+    bool        restoreSnapshot(const BoardSnapshot &snapshot) override;
+    void        applyMoveToSnapshot(BoardSnapshot &snapshot, uint32_t move) const override;
 
 	void        updateAI() override;
+	// the classic board is a table lookup, only the bigger boards search
+	bool        aiSearchStats(SearchStats &stats) override { stats = _ai.stats(); return !isClassicBoard(); }
     bool        gameHasAI() override { return true; }
     Grid* getGrid() override { return _grid; }
+protected:
+    void        applyMove(uint32_t move) override;
+    void        unapplyMove(uint32_t move) override;
+
 private:
     Bit *       PieceForPlayer(const int playerNumber);
     Player*     ownerAt(int index ) const;
-    int         negamax(std::string& state, int depth, int playerColor);
+    int         encodeBoard(int playerToMove) const;
+    static uint32_t encodeMove(int cell, int playerNumber);
+    uint32_t    snapshotVariant() const { return BoardSnapshot::makeVariant('T', _width, _height, _inARow); }
+    void        syncGridFromBoard();
+    bool        isClassicBoard() const { return _width == 3 && _height == 3 && _inARow == 3; }
+    void        cancelAISearch();
 
     Grid*       _grid;
+    int         _width;
+    int         _height;
+    int         _inARow;
+    float       _squareSize;
+
+    // stones mirrored from the grid for win checks and the search
+    TicTacToeBoard _board;
+
+    // bigger boards are searched on a worker thread, updateAI polls for the answer each frame
+    TicTacToeAI _ai;
+    std::future<TicTacToeAI::Result> _aiSearch;
+    static const int kPlanesPerPlayer = TicTacToeBoard::kMaxCells / 64;
+    static const int kAIMaxDepth = 12;
+    static const int kAITimeLimitMs = 1000;
 };
 
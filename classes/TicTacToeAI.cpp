@@ -0,0 +1,95 @@
+#include "TicTacToeAI.h"
+#include "Profiler.h"
+#include <random>
+
+namespace {
+
+// zobrist keys for either player's stone on each cell, whose turn it is follows from the count
+struct ZobristKeys
+{
+    uint64_t stones[TicTacToeBoard::kMaxCells][2];
+
+    ZobristKeys()
+    {
+        std::mt19937_64 rng(0x676f6d6f6b75ull);
+        for (auto &cell : stones) {
+            for (auto &key : cell) {
+                key = rng();
+            }
+        }
+    }
+};
+
+const ZobristKeys &zobrist()
+{
+    static const ZobristKeys keys;
+    return keys;
+}
+
+} // namespace
+
+TicTacToeAI::Position::Position(const TicTacToeBoard &board) : _board(board)
+{
+    const ZobristKeys &keys = zobrist();
+    for (int cell = 0; cell < board.cellCount(); cell++) {
+        if (!board.isEmpty(cell)) {
+            _key ^= keys.stones[cell][board.ownerAt(cell)];
+        }
+    }
+}
+
+TicTacToeAI::TicTacToeAI()
+{
+    // the evaluation moves by a power of eight with every stone, a window around the last
+    // iteration's score misses more often than it saves
+    AlphaBeta<Position>::Options options;
+    options.aspiration = false;
+    _engine.setOptions(options);
+}
+
+void TicTacToeAI::Position::play(Move cell)
+{
+    _key ^= zobrist().stones[cell][_board.sideToMove()];
+    _board.play(cell);
+}
+
+void TicTacToeAI::Position::undo(Move cell)
+{
+    _board.undo(cell);
+    _key ^= zobrist().stones[cell][_board.sideToMove()];
+}
+
+bool TicTacToeAI::Position::terminal(int ply, int &score) const
+{
+    // the player who just moved finished a line, sooner is worse
+    if (_board.winner() >= 0) {
+        score = -(kWinScore - ply);
+        return true;
+    }
+    if (_board.full()) {
+        score = 0;
+        return true;
+    }
+    return false;
+}
+
+TicTacToeAI::Result TicTacToeAI::search(const TicTacToeBoard &board, int maxDepth, int timeLimitMs)
+{
+    PROFILE_SCOPE("TicTacToeAI::search");
+    Result result;
+    int cells[kRootCandidates];
+    int count = board.candidates(cells, kRootCandidates);
+    if (count == 0 || board.winner() >= 0) {
+        return result;
+    }
+
+    // a win to take or a single block comes back as the only candidate, the engine returns it at once
+    Position position(board);
+    AlphaBeta<Position>::Result found = _engine.search(position, cells, count, maxDepth, timeLimitMs);
+    result.cell = found.move;
+    result.score = found.score;
+    result.depth = found.depth;
+    result.nodes = found.nodes;
+    result.found = found.found;
+    return result;
+}
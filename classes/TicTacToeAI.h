@@ -0,0 +1,75 @@
+#pragma once
+
+#include "AlphaBeta.h"
+#include "TicTacToeBoard.h"
+#include "SearchStats.h"
+#include <cstdint>
+
+//
+// negamax alpha-beta searcher for m x n k in a row boards, on the shared AlphaBeta engine
+// iterative deepening under a time limit. only cells near existing stones are searched, a
+// win or a forced block cuts the choice down to those cells, and the rest are ordered by
+// how much they do for both sides with only the best few kept below the root, which is
+// forward pruning on purpose (see kCandidates).
+//
+
+class TicTacToeAI
+{
+public:
+    struct Result
+    {
+        int         cell = -1;
+        int         score = 0;
+        int         depth = 0;
+        uint64_t    nodes = 0;
+        bool        found = false;
+    };
+
+    static const int kWinScore = 1000000000;
+
+    TicTacToeAI();
+
+    // search for up to maxDepth plies or timeLimitMs milliseconds, whichever is first
+    Result      search(const TicTacToeBoard &board, int maxDepth, int timeLimitMs);
+    // ask a running search to return as soon as possible, the request sticks until clearStop
+    void        stop() { _engine.stop(); }
+    void        clearStop() { _engine.clearStop(); }
+    // counters of the running or last search, safe to call from any thread
+    SearchStats stats() const { return _engine.stats(); }
+
+private:
+    // how many cells are searched at the root and below it. wins and forced blocks always
+    // make the list, the rest are the best by cellScore out of everything within two cells
+    // of a stone. keeping only 10 below the root is deliberate forward pruning, the whole
+    // neighbourhood runs to dozens of cells on a big board and would cost several plies of
+    // depth, at the price of missing a low scoring quiet defence deeper in the tree
+    static const int kRootCandidates = 24;
+    static const int kCandidates = 10;
+
+    // the board as the engine sees it, with a zobrist key kept up to date as stones go on and off
+    class Position
+    {
+    public:
+        using Move = int;
+        static const int kMaxMoves = kCandidates;
+        static const int kWinScore = TicTacToeAI::kWinScore;
+        static const int kMoveKeys = TicTacToeBoard::kMaxCells;
+
+        explicit Position(const TicTacToeBoard &board);
+
+        int         generateMoves(Move *cells) const { return _board.candidates(cells, kCandidates); }
+        void        play(Move cell);
+        void        undo(Move cell);
+        int         evaluate() const { return _board.evaluate(); }
+        uint64_t    hash() const { return _key; }
+        bool        terminal(int ply, int &score) const;
+        int         noMovesScore(int) const { return 0; }
+        int         moveKey(Move cell) const { return cell; }
+
+    private:
+        TicTacToeBoard  _board;
+        uint64_t        _key = 0;
+    };
+
+    AlphaBeta<Position>     _engine;
+};
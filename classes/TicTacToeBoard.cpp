@@ -0,0 +1,276 @@
+#include "TicTacToeBoard.h"
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+//
+// line tables are shared between every board of the same shape, the AI copies boards around
+//
+std::shared_ptr<const TicTacToeBoard::Lines> TicTacToeBoard::linesFor(int width, int height, int inARow)
+{
+    static std::mutex mutex;
+    static std::map<std::tuple<int, int, int>, std::shared_ptr<const Lines>> cache;
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto key = std::make_tuple(width, height, inARow);
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    auto lines = std::make_shared<Lines>();
+    lines->width = width;
+    lines->height = height;
+    lines->inARow = inARow;
+    lines->byCell.resize(width * height);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int cell = y * width + x;
+            lines->boardMask.set(cell);
+            if (x > 0) lines->notFirstColumn.set(cell);
+            if (x < width - 1) lines->notLastColumn.set(cell);
+        }
+    }
+
+    // east, south, south east and south west from every starting cell that fits
+    static const int kDirections[4][2] = {{1, 0}, {0, 1}, {1, 1}, {-1, 1}};
+    for (const auto &dir : kDirections) {
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                int endX = x + dir[0] * (inARow - 1);
+                int endY = y + dir[1] * (inARow - 1);
+                if (endX < 0 || endX >= width || endY >= height) {
+                    continue;
+                }
+                int line = (int)lines->masks.size();
+                Bitboard mask;
+                for (int i = 0; i < inARow; i++) {
+                    int cell = (y + dir[1] * i) * width + (x + dir[0] * i);
+                    mask.set(cell);
+                    lines->cells.push_back((uint8_t)cell);
+                    lines->byCell[cell].push_back(line);
+                }
+                lines->masks.push_back(mask);
+            }
+        }
+    }
+
+    // every extra stone in an open line is worth eight times more
+    for (int n = 1; n <= inARow; n++) {
+        lines->weights[n] = 1 << (3 * (n - 1));
+    }
+
+    cache[key] = lines;
+    return lines;
+}
+
+TicTacToeBoard::TicTacToeBoard(int width, int height, int inARow)
+{
+    width = std::clamp(width, 1, 16);
+    height = std::clamp(height, 1, kMaxCells / width);
+    inARow = std::clamp(inARow, 1, std::min(kMaxInARow, std::max(width, height)));
+    _lines = linesFor(width, height, inARow);
+    clear();
+}
+
+void TicTacToeBoard::clear()
+{
+    _stones[0].reset();
+    _stones[1].reset();
+    _occupied.reset();
+    _counts[0].assign(_lines->masks.size(), 0);
+    _counts[1].assign(_lines->masks.size(), 0);
+    _score[0] = 0;
+    _score[1] = 0;
+    _moveCount = 0;
+    _winner = -1;
+}
+
+int TicTacToeBoard::ownerAt(int cell) const
+{
+    if (_stones[0].test(cell)) return 0;
+    if (_stones[1].test(cell)) return 1;
+    return -1;
+}
+
+//
+// a line only counts for a player while the opponent has nothing in it
+//
+int TicTacToeBoard::lineScore(int line, int player) const
+{
+    if (_counts[1 - player][line]) {
+        return 0;
+    }
+    return _lines->weights[_counts[player][line]];
+}
+
+void TicTacToeBoard::play(int cell)
+{
+    int player = sideToMove();
+    for (int line : _lines->byCell[cell]) {
+        _score[0] -= lineScore(line, 0);
+        _score[1] -= lineScore(line, 1);
+        if (++_counts[player][line] == _lines->inARow) {
+            _winner = player;
+        }
+        _score[0] += lineScore(line, 0);
+        _score[1] += lineScore(line, 1);
+    }
+    _stones[player].set(cell);
+    _occupied.set(cell);
+    _moveCount++;
+}
+
+void TicTacToeBoard::undo(int cell)
+{
+    _moveCount--;
+    int player = sideToMove();
+    for (int line : _lines->byCell[cell]) {
+        _score[0] -= lineScore(line, 0);
+        _score[1] -= lineScore(line, 1);
+        _counts[player][line]--;
+        _score[0] += lineScore(line, 0);
+        _score[1] += lineScore(line, 1);
+    }
+    _stones[player].reset(cell);
+    _occupied.reset(cell);
+    // nothing is ever played after a win, so taking back a stone always clears it
+    _winner = -1;
+}
+
+int TicTacToeBoard::evaluate() const
+{
+    int player = sideToMove();
+    return _score[player] - _score[1 - player];
+}
+
+int TicTacToeBoard::cellScore(int cell) const
+{
+    int player = sideToMove();
+    int score = 0;
+    for (int line : _lines->byCell[cell]) {
+        if (!_counts[1 - player][line]) {
+            score += _lines->weights[_counts[player][line] + 1];
+        }
+        if (!_counts[player][line]) {
+            score += _lines->weights[_counts[1 - player][line] + 1];
+        }
+    }
+    return score;
+}
+
+TicTacToeBoard::Bitboard TicTacToeBoard::neighbourhood(int radius) const
+{
+    const Lines &lines = *_lines;
+    Bitboard grown = _occupied;
+    for (int step = 0; step < radius; step++) {
+        Bitboard row = grown | ((grown >> 1) & lines.notLastColumn) | ((grown << 1) & lines.notFirstColumn);
+        grown = (row | (row >> lines.width) | (row << lines.width)) & lines.boardMask;
+    }
+    return grown & ~_occupied;
+}
+
+//
+// empty cells that finish a line for player
+//
+int TicTacToeBoard::findThreat(int player, int *cells, int maxCount) const
+{
+    const Lines &lines = *_lines;
+    int count = 0;
+    for (int line = 0; line < (int)lines.masks.size() && count < maxCount; line++) {
+        if (_counts[player][line] != lines.inARow - 1 || _counts[1 - player][line]) {
+            continue;
+        }
+        for (int i = 0; i < lines.inARow; i++) {
+            int cell = lines.cells[line * lines.inARow + i];
+            if (!_occupied.test(cell)) {
+                if (std::find(cells, cells + count, cell) == cells + count) {
+                    cells[count++] = cell;
+                }
+                break;
+            }
+        }
+    }
+    return count;
+}
+
+int TicTacToeBoard::candidates(int *cells, int maxCount) const
+{
+    if (maxCount <= 0 || full()) {
+        return 0;
+    }
+    int player = sideToMove();
+
+    // take a win, otherwise block one
+    if (findThreat(player, cells, 1)) {
+        return 1;
+    }
+    int blocks = findThreat(1 - player, cells, maxCount);
+    if (blocks) {
+        return blocks;
+    }
+
+    if (_moveCount == 0) {
+        cells[0] = (height() / 2) * width() + width() / 2;
+        return 1;
+    }
+
+    Bitboard near = neighbourhood(2);
+    std::pair<int, int> scored[kMaxCells];
+    int nearCount = 0;
+    for (int cell = 0; cell < cellCount(); cell++) {
+        if (near.test(cell)) {
+            scored[nearCount++] = {cellScore(cell), cell};
+        }
+    }
+    int count = std::min(maxCount, nearCount);
+    std::partial_sort(scored, scored + count, scored + nearCount, [](const auto &a, const auto &b) { return a.first > b.first; });
+    for (int i = 0; i < count; i++) {
+        cells[i] = scored[i].second;
+    }
+    return count;
+}
+
+bool TicTacToeBoard::hasLine(int player) const
+{
+    for (const Bitboard &mask : _lines->masks) {
+        if ((_stones[player] & mask) == mask) {
+            return true;
+        }
+    }
+    return false;
+}
+
+TicTacToeBoard TicTacToeBoard::fromStateString(const std::string &state, int width, int height, int inARow)
+{
+    Bitboard stones[2];
+    for (int cell = 0; cell < kMaxCells && cell < (int)state.length(); cell++) {
+        if (state[cell] == '1') stones[0].set(cell);
+        if (state[cell] == '2') stones[1].set(cell);
+    }
+    return fromStones(stones[0], stones[1], width, height, inARow);
+}
+
+TicTacToeBoard TicTacToeBoard::fromStones(const Bitboard &first, const Bitboard &second, int width, int height, int inARow)
+{
+    TicTacToeBoard board(width, height, inARow);
+    const Bitboard *stones[2] = {&first, &second};
+    // replay alternately so the side to move and the line counts come out right
+    int next[2] = {0, 0};
+    auto skipEmpty = [&](int player) {
+        while (next[player] < board.cellCount() && !stones[player]->test(next[player])) {
+            next[player]++;
+        }
+    };
+    skipEmpty(0);
+    skipEmpty(1);
+    while (next[board.sideToMove()] < board.cellCount()) {
+        int player = board.sideToMove();
+        board.play(next[player]++);
+        skipEmpty(player);
+    }
+    board._winner = board.hasLine(0) ? 0 : (board.hasLine(1) ? 1 : -1);
+    return board;
+}
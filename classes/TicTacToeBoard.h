@@ -0,0 +1,93 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+//
+// bitboard position for m x n boards with k in a row (tic tac toe, gomoku, ...)
+// cells are numbered y * width + x. every k long line on the board is precomputed as a
+// mask, and the board keeps a running count of each player's stones in every line so
+// playing or taking back a stone only touches the lines through that cell.
+//
+
+class TicTacToeBoard
+{
+public:
+    static const int kMaxCells = 256;
+    static constexpr int kMaxInARow = 8;        // constexpr, std::min takes it by reference
+    using Bitboard = std::bitset<kMaxCells>;
+
+    TicTacToeBoard(int width = 3, int height = 3, int inARow = 3);
+
+    int         width() const { return _lines->width; }
+    int         height() const { return _lines->height; }
+    int         inARow() const { return _lines->inARow; }
+    int         cellCount() const { return _lines->width * _lines->height; }
+
+    void        clear();
+    // stones are player numbers, 0 moves first
+    int         ownerAt(int cell) const;
+    bool        isEmpty(int cell) const { return !_occupied.test(cell); }
+    const Bitboard &stones(int player) const { return _stones[player]; }
+    const Bitboard &occupied() const { return _occupied; }
+    int         sideToMove() const { return _moveCount & 1; }
+    int         moveCount() const { return _moveCount; }
+
+    // play a stone for the side to move, and take back the last one
+    void        play(int cell);
+    void        undo(int cell);
+
+    // the player with k in a row, or -1
+    int         winner() const { return _winner; }
+    bool        full() const { return _moveCount == cellCount(); }
+
+    // static evaluation from the point of view of the side to move
+    int         evaluate() const;
+    // how much a stone on cell would do for the side to move, attack plus defence
+    int         cellScore(int cell) const;
+
+    //
+    // moves worth searching, best first: a winning cell if there is one, otherwise the cells
+    // that stop an opponent win, otherwise empty cells near the existing stones.
+    // returns how many were written to cells.
+    //
+    int         candidates(int *cells, int maxCount) const;
+
+    // empty cells within radius steps of any stone
+    Bitboard    neighbourhood(int radius) const;
+
+    // piece digits match the Grid state string: 0 empty, 1 first player, 2 second player
+    static TicTacToeBoard fromStateString(const std::string &state, int width, int height, int inARow);
+    static TicTacToeBoard fromStones(const Bitboard &first, const Bitboard &second, int width, int height, int inARow);
+
+private:
+    struct Lines
+    {
+        int width = 0;
+        int height = 0;
+        int inARow = 0;
+        std::vector<Bitboard>           masks;
+        std::vector<uint8_t>            cells;      // inARow cells for each line
+        std::vector<std::vector<int>>   byCell;     // lines through each cell
+        Bitboard                        boardMask;
+        Bitboard                        notFirstColumn;
+        Bitboard                        notLastColumn;
+        int                             weights[kMaxInARow + 1] = {};
+    };
+
+    static std::shared_ptr<const Lines> linesFor(int width, int height, int inARow);
+    int         lineScore(int line, int player) const;
+    int         findThreat(int player, int *cells, int maxCount) const;
+    bool        hasLine(int player) const;
+
+    std::shared_ptr<const Lines> _lines;
+    Bitboard            _stones[2];
+    Bitboard            _occupied;
+    std::vector<uint8_t> _counts[2];        // stones per line
+    int                 _score[2] = {0, 0};
+    int                 _moveCount = 0;
+    int                 _winner = -1;
+};
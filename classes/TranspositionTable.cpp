@@ -0,0 +1,22 @@
+#include "TranspositionTable.h"
+
+TranspositionTable::TranspositionTable(size_t entries)
+{
+    _bucketCount = 1;
+    while (_bucketCount * kBucketSize < entries) {
+        _bucketCount <<= 1;
+    }
+    _buckets = std::make_unique<Bucket[]>(_bucketCount);
+}
+
+// only safe while no search is using the table
+void TranspositionTable::clear()
+{
+    for (size_t i = 0; i < _bucketCount; i++) {
+        for (Slot &slot : _buckets[i].slots) {
+            slot.check.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    _generation.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+//
+// transposition table any number of search threads can probe and store into at once, with
+// no lock. an entry is two 64 bit words, the packed result and the position key xored with
+// it. each word is read and written atomically but the pair isn't, so a probe that lands
+// between two threads' stores sees a key and a result that don't belong together, the xor
+// no longer gives back the key and the probe just misses. plain 64 bit atomics instead of a
+// 128 bit compare and swap work the same on every compiler and target the game builds for.
+//
+// entries come in buckets of two. the first keeps the deepest result, unless it is from an
+// older search, the second takes whatever the first turned down, so a deep result isn't
+// pushed out by the shallow ones around it but the newest positions still get stored.
+// newSearch() between moves ages everything already in the table.
+//
+
+class TranspositionTable
+{
+public:
+    enum Bound : uint8_t
+    {
+        kNone,      // empty entry
+        kExact,
+        kLower,
+        kUpper
+    };
+
+    struct Entry
+    {
+        int32_t     score = 0;
+        int         depth = 0;
+        Bound       bound = kNone;
+        uint8_t     move = kNoMove;     // the caller's own numbering, an index or a column
+    };
+
+    static const uint8_t kNoMove = 0xff;
+    static const int kMaxDepth = 127;
+
+    // room for at least entries results, rounded up to a power of two
+    explicit TranspositionTable(size_t entries);
+
+    void        clear();
+    // start a new search, what is in the table already gets replaced before anything newer
+    void        newSearch() { _generation.store((_generation.load(std::memory_order_relaxed) + 1) & kGenerationMask, std::memory_order_relaxed); }
+    size_t      size() const { return _bucketCount * kBucketSize; }
+
+    bool        probe(uint64_t key, Entry &entry) const;
+    // returns true when a different position was pushed out to make room
+    bool        store(uint64_t key, int score, int depth, Bound bound, uint8_t move);
+
+private:
+    static const int kBucketSize = 2;
+    static const uint64_t kGenerationMask = 63;
+
+    // score in the low 32 bits, then depth, move, bound and generation a byte each
+    static uint64_t pack(int score, int depth, Bound bound, uint8_t move, uint64_t generation)
+    {
+        return (uint64_t)(uint32_t)score | (uint64_t)(uint8_t)depth << 32 | (uint64_t)move << 40
+             | (uint64_t)bound << 48 | generation << 56;
+    }
+    static int      depthOf(uint64_t data) { return (int8_t)(data >> 32); }
+    static uint8_t  moveOf(uint64_t data) { return (uint8_t)(data >> 40); }
+    static Bound    boundOf(uint64_t data) { return (Bound)((data >> 48) & 0xff); }
+    static uint64_t generationOf(uint64_t data) { return data >> 56; }
+
+    struct Slot
+    {
+        std::atomic<uint64_t> check{0};     // key ^ data
+        std::atomic<uint64_t> data{0};
+    };
+
+    struct alignas(32) Bucket
+    {
+        Slot        slots[kBucketSize];
+    };
+
+    Bucket     &bucketFor(uint64_t key) const { return _buckets[key & (_bucketCount - 1)]; }
+
+    std::unique_ptr<Bucket[]>   _buckets;
+    size_t                      _bucketCount = 0;
+    std::atomic<uint64_t>       _generation{0};
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "transposition table entries need lock free 64 bit atomics");
+
+inline bool TranspositionTable::probe(uint64_t key, Entry &entry) const
+{
+    Bucket &bucket = bucketFor(key);
+    for (Slot &slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.check.load(std::memory_order_relaxed);
+        if ((check ^ data) == key && boundOf(data) != kNone) {
+            entry.score = (int32_t)(uint32_t)data;
+            entry.depth = depthOf(data);
+            entry.bound = boundOf(data);
+            entry.move = moveOf(data);
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool TranspositionTable::store(uint64_t key, int score, int depth, Bound bound, uint8_t move)
+{
+    Bucket &bucket = bucketFor(key);
+    uint64_t generation = _generation.load(std::memory_order_relaxed);
+    if (depth > kMaxDepth) depth = kMaxDepth;
+
+    // the same position goes back where it was, otherwise the deep slot if this is as deep or
+    // what's there is from an older search, and the other slot if not
+    Slot *target = nullptr;
+    for (Slot &slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if ((slot.check.load(std::memory_order_relaxed) ^ data) == key && boundOf(data) != kNone) {
+            target = &slot;
+            // a result without a move keeps the move the position had
+            if (move == kNoMove) move = moveOf(data);
+            break;
+        }
+    }
+    bool pushedOut = false;
+    if (!target) {
+        Slot &deep = bucket.slots[0];
+        uint64_t data = deep.data.load(std::memory_order_relaxed);
+        bool replaceDeep = boundOf(data) == kNone || generationOf(data) != generation || depth >= depthOf(data);
+        target = replaceDeep ? &deep : &bucket.slots[1];
+        pushedOut = boundOf(target->data.load(std::memory_order_relaxed)) != kNone;
+    }
+
+    uint64_t data = pack(score, depth, bound, move, generation);
+    target->data.store(data, std::memory_order_relaxed);
+    target->check.store(key ^ data, std::memory_order_relaxed);
+    return pushedOut;
+}
@@ -121,6 +121,13 @@ int main(int, char**)
     bool show_another_window = false;
     ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
     ClassGame::GameStartUp();
+
+    // Idle frame policy: once the board stops changing on its own we block on input instead of
+    // redrawing at vsync. A few frames still run after every wake up so ImGui can settle hover
+    // and click states, and the timeout keeps anything time based ticking over slowly.
+    const int kSettleFrames = 3;
+    const double kIdleWaitSeconds = 0.5;
+    int settleFrames = kSettleFrames;
     
     // Main loop
 #ifdef __EMSCRIPTEN__
@@ -137,7 +144,29 @@ int main(int, char**)
         // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application, or clear/overwrite your copy of the mouse data.
         // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application, or clear/overwrite your copy of the keyboard data.
         // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
+#ifndef __EMSCRIPTEN__
+        if (ClassGame::WantsContinuousFrames())
+        {
+            settleFrames = kSettleFrames;
+        }
+        if (settleFrames > 0)
+        {
+            settleFrames--;
+            glfwPollEvents();
+        }
+        else
+        {
+            double waitStart = glfwGetTime();
+            glfwWaitEventsTimeout(kIdleWaitSeconds);
+            // woken by input rather than the timeout
+            if (glfwGetTime() - waitStart < kIdleWaitSeconds)
+            {
+                settleFrames = kSettleFrames;
+            }
+        }
+#else
         glfwPollEvents();
+#endif
 
         // Start the Dear ImGui frame
         ImGui_ImplOpenGL3_NewFrame();
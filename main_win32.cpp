@@ -108,10 +108,30 @@ int main(int, char**)
     // Our state
     ClassGame::GameStartUp();
 
+    // Idle frame policy: once the board stops changing on its own we block on input instead of
+    // presenting at vsync. A few frames still run after every wake up so ImGui can settle hover
+    // and click states, and the timeout keeps anything time based ticking over slowly.
+    const int kSettleFrames = 3;
+    const DWORD kIdleWaitMs = 500;
+    int settleFrames = kSettleFrames;
+
     // Main loop
     bool done = false;
     while (!done)
     {
+        if (ClassGame::WantsContinuousFrames())
+        {
+            settleFrames = kSettleFrames;
+        }
+        if (settleFrames > 0)
+        {
+            settleFrames--;
+        }
+        else if (::MsgWaitForMultipleObjects(0, nullptr, FALSE, kIdleWaitMs, QS_ALLINPUT) != WAIT_TIMEOUT)
+        {
+            settleFrames = kSettleFrames;
+        }
+
         // Poll and handle messages (inputs, window resize, etc.)
         // See the WndProc() function below for our to dispatch events to the Win32 backend.
         MSG msg;
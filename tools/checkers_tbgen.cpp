@@ -0,0 +1,37 @@
+//
+// offline generator for the checkers endgame tables
+//
+// usage: checkers_tbgen [maxPieces] [output file]
+//        checkers_tbgen --verify [table file] [samples] [search depth]
+//
+// the game looks for resources/checkers_endgame.cktb at startup, so the default output goes
+// there. four pieces take a few seconds and about 2MB, five pieces take a good deal longer.
+//
+
+#include "CheckersTablebase.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "--verify") == 0) {
+        const char *path = argc > 2 ? argv[2] : CheckersTablebase::defaultPath();
+        int samples = argc > 3 ? atoi(argv[3]) : 2000;
+        int depth = argc > 4 ? atoi(argv[4]) : 9;
+        CheckersTablebase tablebase;
+        if (!tablebase.open(path)) {
+            std::cout << "Could not open " << path << std::endl;
+            return 1;
+        }
+        return tablebase.verify(samples, depth, 12345) == 0 ? 0 : 1;
+    }
+
+    int maxPieces = argc > 1 ? atoi(argv[1]) : 4;
+    const char *path = argc > 2 ? argv[2] : CheckersTablebase::defaultPath();
+    if (!CheckersTablebase::generate(maxPieces, path)) {
+        return 1;
+    }
+    std::cout << "wrote " << path << std::endl;
+    return 0;
+}
@@ -0,0 +1,251 @@
+//
+// benchmark for the connect 4 search
+//
+// usage: connect4_bench [depth] [positions]
+//
+// searches the same random mid game positions several ways. first the engine on a position
+// that copies the whole board for every ply, once scanning the whole board for a four at
+// every node the way the search did before it played in place and once only testing the
+// disc just played, against Connect4AI with every option off. all three walk exactly the
+// same tree, so the node counts and chosen columns have to agree and the difference in time
+// per node is what the copying and the scan cost. then Connect4AI with principal variation, aspiration and the table on,
+// which have to find the same scores in fewer nodes (the table can graft a deeper result
+// into a shallower search, so its scores are only reported).
+//
+
+#include "Connect4AI.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Board = Connect4Position::Board;
+const int kCols = Connect4Position::kCols;
+const int kRows = Connect4Position::kRows;
+const int kColumnOrder[kCols] = {3, 2, 4, 1, 5, 0, 6};
+
+//
+// the copying position, kept to measure against: every ply gets its own copy of the board to
+// drop a disc into and undo just steps back to the one before. with scanWholeBoard every
+// disc on the board is tested for a four at every node, as the old search did, otherwise only
+// the one just played. the same position as Connect4Position otherwise, in the same order
+//
+class CopyingPosition
+{
+public:
+    using Move = int;
+    static const int kMaxMoves = kCols;
+    static const int kMoveKeys = kCols;
+    static const int kWinScore = Connect4Position::kWinScore;
+
+    CopyingPosition(const Board &board, int toMove, bool scanWholeBoard)
+        : _toMove(toMove), _scanWholeBoard(scanWholeBoard)
+    {
+        _boards[0] = board;
+    }
+
+    int generateMoves(Move *cols) const
+    {
+        int count = 0;
+        for (int col : kColumnOrder) {
+            if (board()[col][kRows - 1] == 0) cols[count++] = col;
+        }
+        return count;
+    }
+    void play(int col)
+    {
+        Board &next = _boards[_ply + 1] = _boards[_ply];
+        int row = 0;
+        while (next[col][row] != 0) row++;
+        next[col][row] = _toMove;
+        _cols[_ply++] = col;
+        _toMove = 3 - _toMove;
+    }
+    void undo(int)
+    {
+        _ply--;
+        _toMove = 3 - _toMove;
+    }
+    int evaluate() const { return Connect4Position::evaluate(board(), _toMove); }
+    uint64_t hash() const { return Connect4Position(board(), _toMove).hash(); }
+    bool terminal(int ply, int &score) const
+    {
+        if (_scanWholeBoard) {
+            for (int c = 0; c < kCols; c++) {
+                for (int r = 0; r < kRows && board()[c][r] != 0; r++) {
+                    if (Connect4Position::winAt(board(), c, r, board()[c][r])) {
+                        score = -(kWinScore - ply);
+                        return true;
+                    }
+                }
+            }
+        } else if (_ply > 0) {
+            int col = _cols[_ply - 1];
+            int row = kRows - 1;
+            while (board()[col][row] == 0) row--;
+            if (Connect4Position::winAt(board(), col, row, 3 - _toMove)) {
+                score = -(kWinScore - ply);
+                return true;
+            }
+        }
+        for (int c = 0; c < kCols; c++) {
+            if (board()[c][kRows - 1] == 0) return false;
+        }
+        score = 0;
+        return true;
+    }
+    int noMovesScore(int) const { return 0; }
+    int moveKey(Move col) const { return col; }
+
+private:
+    const Board &board() const { return _boards[_ply]; }
+
+    Board       _boards[kAlphaBetaMaxPly + 1];
+    int         _cols[kAlphaBetaMaxPly] = {};
+    int         _ply = 0;
+    int         _toMove;
+    bool        _scanWholeBoard;
+};
+
+// a few random moves from the empty board, without anyone having won on the way
+bool randomPosition(std::mt19937 &rng, Board &board, int &toMove)
+{
+    Connect4Position position;
+    int plies = 4 + rng() % 12;
+    toMove = 1;
+    for (int i = 0; i < plies; i++) {
+        int col = rng() % kCols;
+        if (!position.canPlay(col)) return false;
+        int row = position.height(col);
+        position.play(col);
+        if (position.winAt(col, row, toMove)) return false;
+        toMove = 3 - toMove;
+    }
+    board = position.board();
+    return true;
+}
+
+double millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int depth = argc > 1 ? atoi(argv[1]) : 8;
+    int count = argc > 2 ? atoi(argv[2]) : 40;
+
+    std::mt19937 rng(12345);
+    std::vector<std::pair<Board, int>> positions;
+    while ((int)positions.size() < count) {
+        Board board;
+        int toMove;
+        if (randomPosition(rng, board, toMove)) {
+            positions.push_back({board, toMove});
+        }
+    }
+
+    auto report = [](const char *name, uint64_t nodes, double ms) {
+        std::cout << name << ": " << nodes << " nodes in " << ms << " ms, "
+                  << (uint64_t)(nodes / (ms / 1000.0)) << " nodes/s, " << ms * 1e6 / nodes << " ns/node" << std::endl;
+    };
+    std::cout << positions.size() << " positions, depth " << depth << std::endl;
+
+    AlphaBeta<CopyingPosition> copying;
+    AlphaBeta<CopyingPosition>::Options copyingOptions;
+    copyingOptions.principalVariation = copyingOptions.aspiration = copyingOptions.table = false;
+    copying.setOptions(copyingOptions);
+    std::vector<int> copyingCols;
+    uint64_t copyingNodes = 0;
+    double copyingMs = 0;
+    int failures = 0;
+    for (bool scan : {true, false}) {
+        std::vector<int> cols;
+        uint64_t nodes = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto &[board, toMove] : positions) {
+            CopyingPosition position(board, toMove, scan);
+            int moves[kCols];
+            int count = position.generateMoves(moves);
+            AlphaBeta<CopyingPosition>::Result result = copying.search(position, moves, count, depth, AlphaBeta<CopyingPosition>::kNoTimeLimit);
+            cols.push_back(result.move);
+            nodes += result.nodes;
+        }
+        double ms = millisecondsSince(start);
+        report(scan ? "copy, scan for fours " : "copy, last disc only ", nodes, ms);
+        if (scan) {
+            copyingCols = cols;
+            copyingNodes = nodes;
+            copyingMs = ms;
+        } else {
+            std::cout << "    speedup over scanning " << copyingMs / ms << "x" << std::endl;
+            if (cols != copyingCols || nodes != copyingNodes) {
+                std::cout << "    the searches disagree" << std::endl;
+                failures++;
+            }
+        }
+    }
+
+    struct Variant
+    {
+        const char  *name;
+        bool        principalVariation;
+        bool        aspiration;
+        bool        table;
+    };
+    const Variant variants[] = {
+        {"make/unmake          ", false, false, false},
+        {"+ principal variation", true, false, false},
+        {"+ aspiration         ", false, true, false},
+        {"+ pvs and aspiration ", true, true, false},
+        {"+ table              ", false, false, true},
+        {"+ all three          ", true, true, true},
+    };
+
+    std::vector<int> plainScores;
+    for (const Variant &variant : variants) {
+        Connect4AI ai;
+        Connect4AI::Options options = ai.options();
+        options.principalVariation = variant.principalVariation;
+        options.aspiration = variant.aspiration;
+        options.table = variant.table;
+        ai.setOptions(options);
+        uint64_t nodes = 0;
+        int differentColumns = 0;
+        int differentScores = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < positions.size(); i++) {
+            Connect4AI::Result result = ai.search(positions[i].first, positions[i].second, depth);
+            nodes += result.nodes;
+            differentColumns += result.column != copyingCols[i];
+            if (&variant == &variants[0]) {
+                plainScores.push_back(result.score);
+            } else {
+                differentScores += result.score != plainScores[i];
+            }
+        }
+        double ms = millisecondsSince(start);
+        report(variant.name, nodes, ms);
+
+        if (&variant == &variants[0]) {
+            std::cout << "    speedup over copying and scanning " << copyingMs / ms << "x" << std::endl;
+            if (differentColumns || nodes != copyingNodes) {
+                std::cout << "    the searches disagree: " << differentColumns << " different columns" << std::endl;
+                failures++;
+            }
+        } else {
+            // equal scores can still pick a different column first
+            std::cout << "    " << (double)copyingNodes / nodes << "x fewer nodes, " << differentColumns << " other columns of equal score" << std::endl;
+            if (differentScores) {
+                std::cout << "    " << differentScores << " scores differ from the full window search" << std::endl;
+                failures += !variant.table;
+            }
+        }
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,106 @@
+//
+// stress test for the lock free transposition table
+//
+// usage: tt_stress [threads] [seconds] [entries]
+//
+// every thread stores and probes random keys from a small range into a small table as fast
+// as it can, so the same slots are being written by several threads at once the whole time.
+// each store makes its score out of the key, depth and move it stores alongside, so a probe
+// that came back with half of one store and half of another would be caught by the score
+// not matching. exits 1 if any probe returned a result that no store ever wrote.
+//
+
+#include "TranspositionTable.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+uint64_t mix(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// the score a store of key with depth and move carries
+int32_t expectedScore(uint64_t key, int depth, uint8_t move)
+{
+    return (int32_t)(uint32_t)mix(key ^ ((uint64_t)depth << 8 | move));
+}
+
+struct Counts
+{
+    uint64_t    stores = 0;
+    uint64_t    probes = 0;
+    uint64_t    hits = 0;
+    uint64_t    torn = 0;
+};
+
+void hammer(TranspositionTable &table, int thread, uint64_t keyRange, const std::atomic<bool> &stop, Counts &counts)
+{
+    uint64_t state = 0x7474737472657373ull + thread;
+    while (!stop.load(std::memory_order_relaxed)) {
+        for (int i = 0; i < 4096; i++) {
+            uint64_t random = mix(state += 0x9e3779b97f4a7c15ull);
+            // keys spread over the whole 64 bits but only keyRange of them, so they keep colliding
+            uint64_t key = mix(random % keyRange + 1);
+            if (random & (1ull << 63)) {
+                int depth = (int)(random >> 40) % (TranspositionTable::kMaxDepth + 1);
+                uint8_t move = (uint8_t)(random >> 48) % TranspositionTable::kNoMove;
+                auto bound = (TranspositionTable::Bound)(TranspositionTable::kExact + (random >> 56) % 3);
+                table.store(key, expectedScore(key, depth, move), depth, bound, move);
+                counts.stores++;
+            } else {
+                TranspositionTable::Entry entry;
+                counts.probes++;
+                if (table.probe(key, entry)) {
+                    counts.hits++;
+                    counts.torn += entry.score != expectedScore(key, entry.depth, entry.move);
+                }
+            }
+        }
+        // a new search now and then so the aged replacement gets exercised too
+        if (thread == 0) {
+            table.newSearch();
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int threads = argc > 1 ? atoi(argv[1]) : (int)std::max(2u, std::thread::hardware_concurrency());
+    double seconds = argc > 2 ? atof(argv[2]) : 5.0;
+    size_t entries = argc > 3 ? (size_t)atoll(argv[3]) : 1024;
+
+    TranspositionTable table(entries);
+    std::atomic<bool> stop{false};
+    std::vector<Counts> counts(threads);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back(hammer, std::ref(table), i, table.size() * 4, std::cref(stop), std::ref(counts[i]));
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop.store(true);
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    Counts total;
+    for (const Counts &c : counts) {
+        total.stores += c.stores;
+        total.probes += c.probes;
+        total.hits += c.hits;
+        total.torn += c.torn;
+    }
+    std::cout << threads << " threads, " << table.size() << " entries, " << seconds << " s" << std::endl;
+    std::cout << total.stores << " stores, " << total.probes << " probes, " << total.hits << " hits, "
+              << total.torn << " torn results" << std::endl;
+    return total.torn == 0 ? 0 : 1;
+}